@@ -1,4 +1,10 @@
+#include <DWARFToCPP/Batch.h>
+#include <DWARFToCPP/BufferedWriter.h>
+#include <DWARFToCPP/Cache.h>
 #include <DWARFToCPP/Parser.h>
+#include <DWARFToCPP/SectionLoader.h>
+#include <DWARFToCPP/SplitUnits.h>
+#include <DWARFToCPP/Tracer.h>
 
 #include <elf++.hh>
 #include <dwarf++.hh>
@@ -17,43 +23,320 @@
 #pragma warning(disable : 4996)
 #endif
 
-#include <fstream>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief Prints the usage of the program
+/// @param program The name of the program
+void PrintUsage(const char* program)
+{
+	std::cout << "Usage: " << program << " [options] <elf:path> <outFile:path>\n"
+		"       " << program << " --batch [options] <elf:path>... <outDir:path>\n"
+		"Options:\n"
+		"  --batch                Parse many ELF files at once, sharing the types they have in\n"
+		"                         common. Prints common.h and a header per file to <outDir>\n"
+		"  --threads=<count>      Parse with <count> threads, 0 for all cores (default 1)\n"
+		"  --root=<glob>          Only parse concepts whose qualified name matches <glob>,\n"
+		"                         and everything they reference. May be repeated\n"
+		"  --root-regex=<regex>   Same as --root, with a regular expression\n"
+		"  --cache=<dir>          Load parsed types from <dir> if the ELF was parsed before,\n"
+		"                         and store them there otherwise. Compilation units that\n"
+		"                         were parsed before are loaded from there as well\n"
+		"  --stream               Print each compilation unit as soon as it is parsed, then\n"
+		"                         free it. Uses far less memory, but classes are only shared\n"
+		"                         within a unit. Can't be used with --cache or --split\n"
+		"  --split=<mode>         Print to the directory <outFile> instead, with one header\n"
+		"                         per top-level <mode>, namespace or class, and all.h\n"
+		"  --dwp=<path>           Read the split units of a -gsplit-dwarf file from the package\n"
+		"                         <path> (default <elf>.dwp if it exists, else the .dwo files)\n"
+		"  --memory-budget=<MB>   Parse a few units at a time, and fewer while the process uses\n"
+		"                         more than <MB> megabytes. Functions and variables are skipped.\n"
+		"                         Implies --stream, which frees each unit once it is printed\n"
+		"  --stats=json           Print what was parsed and where the time went as JSON\n"
+		"  --trace=<path>         Write a timeline of loading, parsing and printing to <path>,\n"
+		"                         for Perfetto or chrome://tracing\n"
+		"  --trace-threshold=<us> Only trace DIEs that take at least <us> microseconds to\n"
+		"                         parse with everything they reference (default 1000)\n";
+}
 
 int main(int argc, char* argv[])
 {
-	if (argc != 3)
+	// options come before the positional arguments
+	size_t threadCount = 1;
+	std::vector<std::pair<std::string_view, bool>> roots;
+	std::string_view cacheDir;
+	std::string_view splitMode;
+	std::string packagePath;
+	bool batch = false;
+	bool streaming = false;
+	size_t memoryBudget = 0;
+	bool printStats = false;
+	std::string tracePath;
+	size_t traceThreshold = 1000;
+	int argIndex = 1;
+	for (; argIndex < argc; ++argIndex)
 	{
-		std::cout << "Usage: " << argv[0] << " <elf:path> <outFile:path>\n";
+		const std::string_view arg = argv[argIndex];
+		if (arg.starts_with("--") == false)
+			break;
+		if (arg.starts_with("--threads=") == true)
+		{
+			const auto count = arg.substr(std::string_view("--threads=").size());
+			if (const auto res = std::from_chars(count.data(), count.data() + count.size(), threadCount);
+				res.ec != std::errc() || res.ptr != count.data() + count.size())
+			{
+				std::cerr << "Invalid thread count " << count << '\n';
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--root=") == true)
+			roots.emplace_back(arg.substr(std::string_view("--root=").size()), false);
+		else if (arg.starts_with("--root-regex=") == true)
+			roots.emplace_back(arg.substr(std::string_view("--root-regex=").size()), true);
+		else if (arg.starts_with("--cache=") == true)
+			cacheDir = arg.substr(std::string_view("--cache=").size());
+		else if (arg.starts_with("--split=") == true)
+		{
+			splitMode = arg.substr(std::string_view("--split=").size());
+			if (splitMode != "namespace" && splitMode != "class")
+			{
+				std::cerr << "Invalid split mode " << splitMode << '\n';
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--memory-budget=") == true)
+		{
+			const auto budget = arg.substr(std::string_view("--memory-budget=").size());
+			if (const auto res = std::from_chars(budget.data(), budget.data() + budget.size(), memoryBudget);
+				res.ec != std::errc() || res.ptr != budget.data() + budget.size() || memoryBudget == 0)
+			{
+				std::cerr << "Invalid memory budget " << budget << '\n';
+				return 1;
+			}
+		}
+		else if (arg == "--batch")
+			batch = true;
+		else if (arg == "--stream")
+			streaming = true;
+		else if (arg.starts_with("--dwp=") == true)
+			packagePath = arg.substr(std::string_view("--dwp=").size());
+		else if (arg.starts_with("--stats=") == true)
+		{
+			const auto statsFormat = arg.substr(std::string_view("--stats=").size());
+			if (statsFormat != "json")
+			{
+				std::cerr << "Invalid statistics format " << statsFormat << '\n';
+				return 1;
+			}
+			printStats = true;
+		}
+		else if (arg.starts_with("--trace=") == true)
+			tracePath = arg.substr(std::string_view("--trace=").size());
+		else if (arg.starts_with("--trace-threshold=") == true)
+		{
+			const auto threshold = arg.substr(std::string_view("--trace-threshold=").size());
+			if (const auto res = std::from_chars(threshold.data(), threshold.data() + threshold.size(), traceThreshold);
+				res.ec != std::errc() || res.ptr != threshold.data() + threshold.size())
+			{
+				std::cerr << "Invalid trace threshold " << threshold << '\n';
+				return 1;
+			}
+		}
+		else
+		{
+			std::cerr << "Unknown option " << arg << '\n';
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (argc - argIndex < 2 || (batch == false && argc - argIndex != 2))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	if (batch == true && (cacheDir.empty() == false || splitMode.empty() == false ||
+		packagePath.empty() == false))
+	{
+		std::cerr << "--cache, --split and --dwp can't be used with --batch\n";
+		return 1;
+	}
+	// only streaming frees what was parsed, so a budget streams
+	if (memoryBudget != 0)
+		streaming = true;
+	if (streaming == true && (batch == true || cacheDir.empty() == false || splitMode.empty() == false))
+	{
+		std::cerr << "--stream and --memory-budget can't be used with --batch, --cache or --split\n";
 		return 1;
 	}
+	const char* elfPath = argv[argIndex];
+	const char* outPath = argv[argc - 1];
+	// scopes record to the tracer for as long as it exists
+	std::optional<DWARFToCPP::Tracer> tracer;
+	if (tracePath.empty() == false)
+		tracer.emplace(std::chrono::microseconds(traceThreshold));
+	const auto writeTrace = [&tracer, &tracePath]()
+	{
+		if (tracer.has_value() == false)
+			return;
+		if (const auto err = tracer->Write(tracePath); err.has_value() == true)
+			std::cerr << err.value() << '\n';
+	};
+	// every argument but the output directory is a file to parse
+	if (batch == true)
+	{
+		DWARFToCPP::Batch batchParser(threadCount);
+		for (const auto& [pattern, regex] : roots)
+			batchParser.AddRoot(pattern, regex);
+		if (const auto err = batchParser.Parse(std::vector<std::string>(argv + argIndex, argv + argc - 1));
+			err.has_value() == true)
+		{
+			std::cerr << err.value() << '\n';
+			return 1;
+		}
+		if (printStats == true)
+			batchParser.Statistics().PrintJSON(std::cout);
+		if (const auto err = batchParser.PrintToDirectory(outPath); err.has_value() == true)
+		{
+			std::cerr << err.value() << '\n';
+			return 1;
+		}
+		writeTrace();
+		return 0;
+	}
 	// open the file
-	int fd = open(argv[1], O_RDONLY);
+	int fd = open(elfPath, O_RDONLY);
 	if (fd < 0)
 	{
-		std::cerr << "Failed to open file " << argv[1] << ": " << errno << '\n';
+		std::cerr << "Failed to open file " << elfPath << ": " << errno << '\n';
 		return 1;
 	}
 	try
 	{
+		DWARFToCPP::TraceScope loadScope("load", "ELF load");
 		elf::elf e(elf::create_mmap_loader(fd));
-		dwarf::dwarf d(dwarf::elf::create_loader(e));
-		// create a parser
-		DWARFToCPP::Parser parser;
-		if (const auto err = parser.ParseDWARF(d);
-			err.has_value() == true)
+		// compressed sections are decompressed on every thread
+		auto sectionLoader = std::make_shared<DWARFToCPP::SectionLoader>(e);
+		if (const auto err = sectionLoader->Decompress(threadCount); err.has_value() == true)
+		{
+			std::cerr << "Failed to decompress DWARF data: " << err.value() << '\n';
+			return 1;
+		}
+		dwarf::dwarf d(sectionLoader);
+		// skeleton units are replaced by the units they point to
+		if (packagePath.empty() == true)
+		{
+			std::error_code error;
+			if (std::filesystem::exists(std::string(elfPath) + ".dwp", error) == true)
+				packagePath = std::string(elfPath) + ".dwp";
+		}
+		DWARFToCPP::SplitUnits splitUnits;
+		if (const auto err = splitUnits.Open(e, d, packagePath, threadCount); err.has_value() == true)
 		{
-			std::cerr << "Failed to parse DWARF data: " << err.value() << '\n';
+			std::cerr << err.value() << '\n';
 			return 1;
 		}
-		// open the output file
-		std::ofstream outFile(argv[2]);
-		if (outFile.good() == false)
+		if (splitUnits.MissingCount() != 0)
+			std::cerr << "Warning: " << splitUnits.MissingCount() <<
+				" split units were not found, and only their skeletons are parsed\n";
+		loadScope.End();
+		// the roots change what is parsed, so they are part of the key
+		std::string cacheKey, cachePath;
+		if (cacheDir.empty() == false)
+		{
+			std::string rootKey;
+			for (const auto& [pattern, regex] : roots)
+				rootKey.append(regex == true ? "r:" : "g:").append(pattern).append("\n");
+			// functions and variables aren't parsed under a budget
+			if (memoryBudget != 0)
+				rootKey.append("budget\n");
+			cacheKey = DWARFToCPP::GetCacheKey(e, rootKey);
+			cachePath = (std::filesystem::path(cacheDir) / (cacheKey + ".cache")).string();
+		}
+		// open the output file. when streaming, types are printed
+		// while the rest are still being parsed
+		std::optional<DWARFToCPP::BufferedWriter> outBuffer;
+		std::ostream outFile(nullptr);
+		if (splitMode.empty() == true)
+		{
+			outBuffer.emplace(outPath);
+			outFile.rdbuf(&outBuffer.value());
+			if (outBuffer->Good() == false)
+			{
+				std::cerr << "Failed to open output file " << outPath << '\n';
+				return 1;
+			}
+		}
+		// create a parser
+		auto parser = std::make_unique<DWARFToCPP::Parser>(threadCount);
+		if (cachePath.empty() == true || parser->LoadCache(cachePath, cacheKey).has_value() == true)
+		{
+			// a cache that failed to load may have left anything behind
+			if (cachePath.empty() == false)
+				parser = std::make_unique<DWARFToCPP::Parser>(threadCount);
+			for (const auto& [pattern, regex] : roots)
+			{
+				if (const auto err = parser->AddRoot(pattern, regex);
+					err.has_value() == true)
+				{
+					std::cerr << err.value() << '\n';
+					return 1;
+				}
+			}
+			parser->SetFile(e);
+			parser->SetSplitUnits(splitUnits);
+			parser->SetMemoryBudget(memoryBudget << 20);
+			if (cachePath.empty() == false)
+				parser->SetUnitCache((std::filesystem::path(cacheDir) / "units").string(), e);
+			if (const auto err = (streaming == true) ?
+				parser->StreamDWARF(d, outFile) : parser->ParseDWARF(d);
+				err.has_value() == true)
+			{
+				std::cerr << "Failed to parse DWARF data: " << err.value() << '\n';
+				return 1;
+			}
+			if (const auto& err = parser->UnitCacheError(); err.has_value() == true)
+				std::cerr << "Warning: failed to cache units: " << err.value() << '\n';
+			if (cachePath.empty() == false)
+			{
+				std::error_code error;
+				std::filesystem::create_directories(cacheDir, error);
+				// a missing cache only costs time, so keep going
+				if (const auto err = parser->SaveCache(cachePath, cacheKey);
+					err.has_value() == true)
+					std::cerr << "Failed to save cache: " << err.value() << '\n';
+			}
+		}
+		if (printStats == true)
+			parser->Statistics().PrintJSON(std::cout);
+		if (splitMode.empty() == false)
+		{
+			if (const auto err = parser->PrintToDirectory(outPath, splitMode == "class");
+				err.has_value() == true)
+			{
+				std::cerr << err.value() << '\n';
+				return 1;
+			}
+			writeTrace();
+			return 0;
+		}
+		if (streaming == false)
+			parser->PrintToFile(outFile);
+		outFile.flush();
+		if (outBuffer->Close() == false)
 		{
-			std::cerr << "Failed to open output file " << argv[2] << '\n';
+			std::cerr << "Failed to write output file " << outPath << '\n';
 			return 1;
 		}
-		parser.PrintToFile(outFile);
+		writeTrace();
 	}
 	catch (const std::exception& e)
 	{
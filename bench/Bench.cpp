@@ -0,0 +1,484 @@
+#include <DWARFToCPP/Attributes.h>
+#include <DWARFToCPP/DIEMemo.h>
+#include <DWARFToCPP/Parser.h>
+
+#include <Fixtures.h>
+
+#include <elf++.hh>
+#include <dwarf++.hh>
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// every allocation through operator new, on any thread
+	std::atomic_size_t g_allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	++g_allocations;
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace DWARFToCPP
+{
+	/// @brief Times loading, parsing and printing through the parser's
+	/// public interface. Merging is part of parsing, and is also timed
+	/// on its own by the parser
+	class Benchmark
+	{
+	public:
+		enum class Phase
+		{
+			Load,
+			Parse,
+			Merge,
+			Print,
+			Count
+		};
+
+		struct Sample
+		{
+			double seconds = std::numeric_limits<double>::max();
+			size_t allocations = 0;
+			// merging is timed by the parser, which doesn't count allocations
+			bool allocationsCounted = true;
+		};
+
+		/// @brief Lookups of every DIE in the memo of its unit under the
+		/// unit's parse mutex, and in the std::unordered_map of shared
+		/// pointers the parser's memo used to be
+		struct MemoSample
+		{
+			double flatSeconds = std::numeric_limits<double>::max();
+			double mapSeconds = std::numeric_limits<double>::max();
+			size_t lookups = 0;
+		};
+
+		/// @brief Reads of what the parsers read from every DIE, through
+		/// Attributes and through die::resolve
+		struct AttributeSample
+		{
+			double attributeSeconds = std::numeric_limits<double>::max();
+			double resolveSeconds = std::numeric_limits<double>::max();
+			size_t reads = 0;
+		};
+
+		/// @param threadCount The number of threads to parse with
+		explicit Benchmark(size_t threadCount) noexcept :
+			m_threadCount(threadCount) {}
+
+		/// @brief Runs every phase once, and keeps the fastest time of each
+		/// @param path The path of the ELF file
+		/// @return The error, if one occurs
+		std::optional<std::string> Run(const char* path) noexcept;
+
+		/// @param phase A phase
+		/// @return The fastest run of the phase
+		const Sample& GetSample(Phase phase) const noexcept { return m_samples[static_cast<size_t>(phase)]; }
+		/// @return The fastest memo lookups
+		const MemoSample& GetMemoSample() const noexcept { return m_memoSample; }
+		/// @return The fastest attribute reads
+		const AttributeSample& GetAttributeSample() const noexcept { return m_attributeSample; }
+		/// @return The number of DIEs in the file
+		size_t DIECount() const noexcept { return m_dieCount; }
+		/// @return The size of .debug_info
+		size_t InfoSize() const noexcept { return m_infoSize; }
+	private:
+		/// @brief Discards everything printed to it
+		class NullBuffer : public std::streambuf
+		{
+		protected:
+			int overflow(int c) override { return c; }
+			std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+		};
+
+		/// @brief Records a run of a phase
+		/// @param phase The phase
+		/// @param start When the phase started
+		/// @param allocations The allocation count when the phase started
+		/// @param excludedSeconds Time spent in a phase nested in this one
+		void Record(Phase phase, std::chrono::steady_clock::time_point start,
+			size_t allocations, double excludedSeconds = 0) noexcept;
+
+		/// @brief Has the same layout as the parser's memo entries
+		struct MemoEntry
+		{
+			Named* named;
+			std::thread::id parsingThread;
+			bool parsed;
+			void* frame;
+			const void* handler;
+		};
+
+		/// @brief Times looking up every DIE the way RequestDIE does, in a
+		/// memo per unit that is reserved like PushCompilationUnit does,
+		/// and the way ParseDIE did before units were parsed in parallel
+		/// @param units The units of the file
+		void MeasureMemo(const std::vector<dwarf::compilation_unit>& units) noexcept;
+
+		/// @brief Times reading the name, type, declaration and specification
+		/// of every DIE, as the parsers do
+		/// @param units The units of the file
+		void MeasureAttributes(const std::vector<dwarf::compilation_unit>& units) noexcept;
+
+		/// @brief Reads the attributes of a DIE and all of its descendants
+		/// @param die The DIE
+		/// @param read Reads the attributes of one DIE
+		/// @return The number of attributes the DIEs have
+		template<typename Read>
+		static size_t ReadAttributes(const dwarf::die& die, Read& read) noexcept;
+
+		/// @brief Finds the offsets of a DIE and all of its descendants
+		/// @param die The DIE
+		/// @param offsets The offsets
+		static void CollectOffsets(const dwarf::die& die, std::vector<uint64_t>& offsets) noexcept;
+
+		size_t m_threadCount;
+		Sample m_samples[static_cast<size_t>(Phase::Count)];
+		MemoSample m_memoSample;
+		AttributeSample m_attributeSample;
+		// the size of each unit and the offsets of its DIEs, in the
+		// order they are looked up
+		std::vector<std::pair<size_t, std::vector<uint64_t>>> m_units;
+		size_t m_dieCount = 0;
+		size_t m_infoSize = 0;
+	};
+}
+
+using namespace DWARFToCPP;
+
+std::optional<std::string> Benchmark::Run(const char* path) noexcept
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return "Failed to open file " + std::string(path);
+	try
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto allocations = g_allocations.load();
+		// libelfin loads lazily, so load what ParseDWARF would
+		// have loaded before parsing
+		elf::elf e(elf::create_mmap_loader(fd));
+		dwarf::dwarf d(dwarf::elf::create_loader(e));
+		try
+		{
+			d.get_section(dwarf::section_type::str);
+		}
+		catch (const std::exception&)
+		{
+			// not every file has a string section
+		}
+		const auto& units = d.compilation_units();
+		for (const auto& compilationUnit : units)
+			compilationUnit.root();
+		Record(Phase::Load, start, allocations);
+		if (m_dieCount == 0)
+		{
+			m_infoSize = e.get_section(".debug_info").size();
+			// references jump around a unit, so lookups are in no particular order
+			std::mt19937_64 random(0);
+			for (size_t unitIndex = 0; unitIndex < units.size(); ++unitIndex)
+			{
+				const auto offset = units[unitIndex].get_section_offset();
+				const size_t end = (unitIndex + 1 < units.size()) ?
+					units[unitIndex + 1].get_section_offset() : std::max<size_t>(m_infoSize, offset);
+				auto& [bytes, offsets] = m_units.emplace_back(end - offset, std::vector<uint64_t>());
+				CollectOffsets(units[unitIndex].root(), offsets);
+				std::shuffle(offsets.begin(), offsets.end(), random);
+				m_dieCount += offsets.size();
+			}
+		}
+		MeasureMemo(units);
+		MeasureAttributes(units);
+		// merging is timed by the parser, and is taken out of parsing
+		Parser parser(m_threadCount);
+		parser.SetFile(e);
+		start = std::chrono::steady_clock::now();
+		allocations = g_allocations.load();
+		if (auto error = parser.ParseDWARF(d); error.has_value() == true)
+			return error;
+		const double mergeSeconds = parser.Statistics().mergeSeconds;
+		Record(Phase::Parse, start, allocations, mergeSeconds);
+		auto& mergeSample = m_samples[static_cast<size_t>(Phase::Merge)];
+		mergeSample.seconds = std::min(mergeSample.seconds, mergeSeconds);
+		mergeSample.allocationsCounted = false;
+		NullBuffer nullBuffer;
+		std::ostream nullFile(&nullBuffer);
+		start = std::chrono::steady_clock::now();
+		allocations = g_allocations.load();
+		parser.PrintToFile(nullFile);
+		Record(Phase::Print, start, allocations);
+	}
+	catch (const std::exception& e)
+	{
+		return "Failed to benchmark " + std::string(path) + ": " + e.what();
+	}
+	return std::nullopt;
+}
+
+void Benchmark::Record(Phase phase, std::chrono::steady_clock::time_point start,
+	size_t allocations, double excludedSeconds) noexcept
+{
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	auto& sample = m_samples[static_cast<size_t>(phase)];
+	// allocations don't change between runs, time does
+	sample.allocations = g_allocations.load() - allocations;
+	sample.seconds = std::min(sample.seconds, elapsed.count() - excludedSeconds);
+}
+
+void Benchmark::MeasureMemo(const std::vector<dwarf::compilation_unit>& units) noexcept
+{
+	// a DIE is looked up about once per reference to it, so each is
+	// looked up a few times to time more than the first cache miss
+	constexpr size_t Rounds = 4;
+	// each unit parser has a memo and a parse mutex of its own. the
+	// parser used to have one map for every unit, keyed by a pointer
+	// made from the unit and offset
+	std::vector<DIEMemo<MemoEntry>> memos(m_units.size());
+	std::vector<std::mutex> mutexes(m_units.size());
+	std::unordered_map<const void*, std::shared_ptr<Named>> oldMemo;
+	for (size_t unitIndex = 0; unitIndex < m_units.size(); ++unitIndex)
+	{
+		const auto& [bytes, offsets] = m_units[unitIndex];
+		const auto& unit = units[unitIndex];
+		auto& memo = memos[unitIndex];
+		// the same estimate PushCompilationUnit reserves with
+		memo.Reserve(bytes / 32);
+		for (const auto offset : offsets)
+		{
+			auto named = std::make_shared<Ignored>();
+			memo.Emplace(memo.GetKey(unit, offset),
+				MemoEntry{ named.get(), std::this_thread::get_id(), true, nullptr, nullptr });
+			oldMemo.emplace(reinterpret_cast<const char*>(&unit) + offset, std::move(named));
+		}
+	}
+	const auto timeLookups = [this, &units](auto lookup)
+	{
+		size_t found = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t round = 0; round < Rounds; ++round)
+		{
+			for (size_t unitIndex = 0; unitIndex < m_units.size(); ++unitIndex)
+			{
+				for (const auto offset : m_units[unitIndex].second)
+					found += lookup(unitIndex, units[unitIndex], offset);
+			}
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return std::make_pair(elapsed.count(), found);
+	};
+	const auto [flatSeconds, flatFound] = timeLookups([&memos, &mutexes](size_t unitIndex,
+		const dwarf::unit& unit, uint64_t offset)
+		{
+			std::scoped_lock lock(mutexes[unitIndex]);
+			auto& memo = memos[unitIndex];
+			const auto entry = memo.Find(memo.GetKey(unit, offset));
+			return static_cast<size_t>(entry != nullptr && entry->parsed == true);
+		});
+	const auto [mapSeconds, mapFound] = timeLookups([&oldMemo](size_t,
+		const dwarf::unit& unit, uint64_t offset)
+		{
+			const auto parsedIt = oldMemo.find(reinterpret_cast<const char*>(&unit) + offset);
+			if (parsedIt == oldMemo.end())
+				return size_t(0);
+			// ParseDIE returned a copy of the pointer
+			const std::shared_ptr<Named> named = parsedIt->second;
+			return static_cast<size_t>(named != nullptr);
+		});
+	// every lookup is a hit, which also keeps them from being optimized out
+	m_memoSample.lookups = std::min(flatFound, mapFound);
+	m_memoSample.flatSeconds = std::min(m_memoSample.flatSeconds, flatSeconds);
+	m_memoSample.mapSeconds = std::min(m_memoSample.mapSeconds, mapSeconds);
+}
+
+void Benchmark::MeasureAttributes(const std::vector<dwarf::compilation_unit>& units) noexcept
+{
+	const auto timeReads = [&units](auto read)
+	{
+		size_t found = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& unit : units)
+			found += ReadAttributes(unit.root(), read);
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return std::make_pair(elapsed.count(), found);
+	};
+	const auto [attributeSeconds, attributeFound] = timeReads([](const dwarf::die& die)
+		{
+			const Attributes attributes(die);
+			return static_cast<size_t>(attributes.Resolve(dwarf::DW_AT::name).valid()) +
+				static_cast<size_t>(attributes.Resolve(dwarf::DW_AT::type).valid()) +
+				static_cast<size_t>(attributes.Has(dwarf::DW_AT::declaration)) +
+				static_cast<size_t>(attributes.Has(dwarf::DW_AT::specification));
+		});
+	const auto [resolveSeconds, resolveFound] = timeReads([](const dwarf::die& die)
+		{
+			return static_cast<size_t>(die.resolve(dwarf::DW_AT::name).valid()) +
+				static_cast<size_t>(die.resolve(dwarf::DW_AT::type).valid()) +
+				static_cast<size_t>(die.has(dwarf::DW_AT::declaration)) +
+				static_cast<size_t>(die.has(dwarf::DW_AT::specification));
+		});
+	// both read the same attributes, which also keeps them from being optimized out
+	m_attributeSample.reads = std::min(attributeFound, resolveFound);
+	m_attributeSample.attributeSeconds = std::min(m_attributeSample.attributeSeconds, attributeSeconds);
+	m_attributeSample.resolveSeconds = std::min(m_attributeSample.resolveSeconds, resolveSeconds);
+}
+
+template<typename Read>
+size_t Benchmark::ReadAttributes(const dwarf::die& die, Read& read) noexcept
+{
+	size_t found = read(die);
+	for (const auto& child : die)
+		found += ReadAttributes(child, read);
+	return found;
+}
+
+void Benchmark::CollectOffsets(const dwarf::die& die, std::vector<uint64_t>& offsets) noexcept
+{
+	offsets.push_back(die.get_section_offset());
+	for (const auto& child : die)
+		CollectOffsets(child, offsets);
+}
+
+/// @brief Prints the usage of the program
+/// @param program The name of the program
+void PrintUsage(const char* program)
+{
+	std::cout << "Usage: " << program << " [options] [elf:path...]\n"
+		"Without any files, the fixtures built with the benchmark are used\n"
+		"Options:\n"
+		"  --threads=<count>      Parse with <count> threads, 0 for all cores (default 1)\n"
+		"  --iterations=<count>   Run each file <count> times, keeping the fastest (default 5)\n";
+}
+
+/// @brief Parses a count option
+/// @param value The value of the option
+/// @param count The count
+/// @return Whether or not the value is a valid count
+bool ParseCount(std::string_view value, size_t& count)
+{
+	const auto res = std::from_chars(value.data(), value.data() + value.size(), count);
+	return res.ec == std::errc() && res.ptr == value.data() + value.size();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t threadCount = 1;
+	size_t iterations = 5;
+	std::vector<const char*> paths;
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const std::string_view arg = argv[argIndex];
+		if (arg.starts_with("--threads=") == true)
+		{
+			if (ParseCount(arg.substr(std::string_view("--threads=").size()), threadCount) == false)
+			{
+				std::cerr << "Invalid thread count " << arg << '\n';
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--iterations=") == true)
+		{
+			if (ParseCount(arg.substr(std::string_view("--iterations=").size()), iterations) == false ||
+				iterations == 0)
+			{
+				std::cerr << "Invalid iteration count " << arg << '\n';
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--") == true)
+		{
+			std::cerr << "Unknown option " << arg << '\n';
+			PrintUsage(argv[0]);
+			return 1;
+		}
+		else
+			paths.push_back(argv[argIndex]);
+	}
+	if (paths.empty() == true)
+	{
+		for (auto fixture = BenchFixtures; *fixture != nullptr; ++fixture)
+			paths.push_back(*fixture);
+	}
+	if (paths.empty() == true)
+	{
+		std::cerr << "No fixtures were built and no files were given\n";
+		return 1;
+	}
+	constexpr const char* phaseNames[] = { "load", "parse", "merge", "print" };
+	printf("%-40s %-6s %10s %10s %12s %10s\n",
+		"file", "phase", "ms", "ns/DIE", "allocs/DIE", "MB/s");
+	for (const auto path : paths)
+	{
+		Benchmark benchmark(threadCount);
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			if (const auto err = benchmark.Run(path); err.has_value() == true)
+			{
+				std::cerr << err.value() << '\n';
+				return 1;
+			}
+		}
+		const auto dieCount = static_cast<double>(std::max<size_t>(benchmark.DIECount(), 1));
+		const std::string_view name = path;
+		for (size_t phase = 0; phase < static_cast<size_t>(Benchmark::Phase::Count); ++phase)
+		{
+			const auto& sample = benchmark.GetSample(static_cast<Benchmark::Phase>(phase));
+			// the allocations of merging are counted with parsing
+			char allocations[16] = "-";
+			if (sample.allocationsCounted == true)
+				snprintf(allocations, sizeof(allocations), "%.2f",
+					static_cast<double>(sample.allocations) / dieCount);
+			printf("%-40s %-6s %10.3f %10.1f %12s %10.1f\n",
+				std::string(name.substr(name.find_last_of('/') + 1)).c_str(), phaseNames[phase],
+				sample.seconds * 1e3, sample.seconds * 1e9 / dieCount, allocations,
+				static_cast<double>(benchmark.InfoSize()) / sample.seconds / 1e6);
+		}
+		const auto& memo = benchmark.GetMemoSample();
+		const auto lookups = static_cast<double>(std::max<size_t>(memo.lookups, 1));
+		printf("%-40s %-6s %10.1f ns/lookup, %.1f before units were parsed in parallel (%.2fx)\n",
+			std::string(name.substr(name.find_last_of('/') + 1)).c_str(), "memo",
+			memo.flatSeconds * 1e9 / lookups, memo.mapSeconds * 1e9 / lookups,
+			memo.mapSeconds / memo.flatSeconds);
+		const auto& attributes = benchmark.GetAttributeSample();
+		printf("%-40s %-6s %10.1f ns/DIE, %.1f through die::resolve (%.2fx)\n",
+			std::string(name.substr(name.find_last_of('/') + 1)).c_str(), "attrs",
+			attributes.attributeSeconds * 1e9 / dieCount, attributes.resolveSeconds * 1e9 / dieCount,
+			attributes.resolveSeconds / attributes.attributeSeconds);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// deep inheritance: long single chains, virtual functions at every
+// level and diamonds through virtual bases
+
+template<int N>
+struct Chain : Chain<N - 1>
+{
+	int member = N;
+	virtual int Get() const { return member + Chain<N - 1>::Get(); }
+	virtual ~Chain() = default;
+};
+
+template<>
+struct Chain<0>
+{
+	virtual int Get() const { return 0; }
+	virtual ~Chain() = default;
+};
+
+template<int N>
+struct Left : virtual Chain<N> {};
+
+template<int N>
+struct Right : virtual Chain<N> {};
+
+template<int N>
+struct Diamond : Left<N>, Right<N>
+{
+	int Get() const override { return Left<N>::member; }
+};
+
+int main()
+{
+	Chain<192> chain;
+	Diamond<16> d16;
+	Diamond<32> d32;
+	Diamond<64> d64;
+	return chain.Get() + d16.Get() + d32.Get() + d64.Get();
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+// included by every generated unit, so the same types appear in
+// each unit and have to be merged
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Shared
+{
+	struct Record
+	{
+		std::string name;
+		std::vector<int> values;
+		std::map<std::string, double> weights;
+	};
+
+	class Registry
+	{
+	public:
+		virtual ~Registry() = default;
+		virtual void Add(const Record& record) { m_records.push_back(record); }
+	private:
+		std::vector<Record> m_records;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+// heavy template instantiation: recursive templates, variadic
+// packs and standard containers of each other
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+template<int N>
+struct Nested
+{
+	Nested<N - 1> inner;
+	std::vector<Nested<N - 1>> list;
+	int value = N;
+};
+
+template<>
+struct Nested<0>
+{
+	int value = 0;
+};
+
+template<typename... Ts>
+struct Pack
+{
+	std::tuple<Ts...> values;
+	std::map<int, std::tuple<Ts...>> indexed;
+};
+
+template<typename T, int N>
+struct Matrix
+{
+	T cells[N][N];
+	Matrix<T, N> operator*(const Matrix<T, N>&) const { return *this; }
+};
+
+int main()
+{
+	Nested<48> nested;
+	Pack<int, float, double, char, std::string> pack;
+	Pack<std::vector<int>, std::map<std::string, int>, std::unique_ptr<int>> containers;
+	std::unordered_map<std::string, std::vector<std::map<int, std::string>>> deep;
+	Matrix<float, 4> a{};
+	Matrix<double, 8> b{};
+	Matrix<int, 16> c{};
+	return nested.value + static_cast<int>(pack.indexed.size() + containers.indexed.size() +
+		deep.size()) + static_cast<int>((a * a).cells[0][0] + (b * b).cells[0][0]) + (c * c).cells[0][0];
+}
\ No newline at end of file
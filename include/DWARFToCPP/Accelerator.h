@@ -0,0 +1,72 @@
+#ifndef DWARFTOCPP_ACCELERATOR_H_
+#define DWARFTOCPP_ACCELERATOR_H_
+
+/// @file
+/// Name Lookups Through Linker-Generated Accelerator Tables
+/// 10/16/26 18:30
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Finds the compilation units that define a name without
+	/// reading any DIEs, through .debug_names, .gdb_index, or
+	/// .debug_pubnames and .debug_pubtypes, whichever the file has
+	class AcceleratorIndex
+	{
+	public:
+		/// @brief Where a name is defined
+		struct Location
+		{
+			// the offset of the compilation unit in .debug_info
+			dwarf::section_offset unitOffset;
+			// the offset of the DIE in .debug_info, if the table has it
+			std::optional<dwarf::section_offset> dieOffset;
+		};
+
+		/// @param file The ELF file, which must outlive the index
+		explicit AcceleratorIndex(const elf::elf& file) noexcept;
+
+		/// @return Whether or not the file has any accelerator table
+		bool Valid() const noexcept;
+
+		/// @brief Finds every definition of a name. Tables may store
+		/// qualified or unqualified names, so look up both
+		/// @param name The name
+		/// @param locations The locations to add the definitions to
+		/// @return Whether or not the tables could be read. A name that
+		/// is not found is not an error
+		bool Find(std::string_view name, std::vector<Location>& locations) const noexcept;
+	private:
+		/// @brief Looks a name up in every name index of .debug_names
+		bool FindDebugNames(std::string_view name, std::vector<Location>& locations) const noexcept;
+		/// @brief Looks a name up in .gdb_index, which only knows the units
+		bool FindGdbIndex(std::string_view name, std::vector<Location>& locations) const noexcept;
+		/// @brief Looks a name up in every set of a .debug_pubnames
+		/// or .debug_pubtypes section
+		static bool FindPubNames(std::string_view section, std::string_view name,
+			std::vector<Location>& locations) noexcept;
+
+		std::string_view m_debugNames;
+		std::string_view m_gdbIndex;
+		std::string_view m_pubNames;
+		std::string_view m_pubTypes;
+		std::string_view m_strings;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef DWARFTOCPP_ARENA_H_
+#define DWARFTOCPP_ARENA_H_
+
+/// @file
+/// Bump Allocator For Parsed Nodes
+/// 10/16/26 12:05
+
+// STL includes
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Allocates objects out of large blocks. Every object is
+	/// destroyed and every block is freed when the arena is destroyed
+	class Arena
+	{
+	public:
+		Arena() noexcept = default;
+		Arena(const Arena&) = delete;
+		Arena(Arena&& other) noexcept;
+		Arena& operator=(const Arena&) = delete;
+		Arena& operator=(Arena&& other) noexcept;
+		~Arena();
+
+		/// @brief Constructs an object in the arena
+		/// @tparam T The type of the object
+		/// @tparam ...Args The constructor argument types
+		/// @param ...args The constructor arguments
+		/// @return The object, which lives as long as the arena
+		template<typename T, typename... Args>
+		T* Create(Args&&... args) noexcept
+		{
+			T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if constexpr (std::is_trivially_destructible_v<T> == false)
+				m_destructors.push_back({ object, [](void* destroyed) noexcept
+					{ static_cast<T*>(destroyed)->~T(); } });
+			return object;
+		}
+
+		/// @brief Allocates uninitialized memory in the arena
+		/// @param size The size of the memory
+		/// @param alignment The alignment of the memory
+		/// @return The memory
+		void* Allocate(size_t size, size_t alignment) noexcept;
+
+		/// @brief Takes ownership of every object in another arena
+		/// @param other The other arena, which is left empty
+		void Adopt(Arena&& other) noexcept;
+
+		/// @return The number of bytes reserved for blocks
+		size_t BytesReserved() const noexcept { return m_bytesReserved; }
+	private:
+		static constexpr size_t BlockSize = 64 * 1024;
+
+		struct Destructor
+		{
+			void* object;
+			void (*destroy)(void*) noexcept;
+		};
+
+		/// @brief Destroys every object and frees every block
+		void Release() noexcept;
+
+		std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+		std::vector<Destructor> m_destructors;
+		std::byte* m_cursor = nullptr;
+		std::byte* m_end = nullptr;
+		size_t m_bytesReserved = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef DWARFTOCPP_ATTRIBUTES_H_
+#define DWARFTOCPP_ATTRIBUTES_H_
+
+/// @file
+/// Reading the Attributes of a DIE in One Pass
+/// 10/16/26 22:20
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <array>
+#include <cstdint>
+
+namespace DWARFToCPP
+{
+	/// @brief Decodes the attributes the parser reads from a DIE at most
+	/// once each, however often they are looked at or resolved through,
+	/// without building the DIE's attribute list
+	class Attributes
+	{
+	public:
+		/// @param die The DIE, which must outlive the attributes
+		explicit Attributes(const dwarf::die& die) noexcept;
+
+		/// @param attribute An attribute
+		/// @return Whether or not the DIE itself has the attribute
+		bool Has(dwarf::DW_AT attribute) const noexcept;
+		/// @param attribute An attribute
+		/// @return The attribute of the DIE itself, or an invalid value
+		dwarf::value Get(dwarf::DW_AT attribute) const noexcept;
+		/// @brief Finds an attribute like die::resolve, which also looks in
+		/// the DIE's abstract origin or specification
+		/// @param attribute An attribute
+		/// @return The attribute, or an invalid value
+		dwarf::value Resolve(dwarf::DW_AT attribute) const noexcept;
+	private:
+		// the attributes that are decoded. the rest are read through the DIE
+		static constexpr std::array Decoded{ dwarf::DW_AT::name, dwarf::DW_AT::type,
+			dwarf::DW_AT::accessibility, dwarf::DW_AT::byte_size, dwarf::DW_AT::const_value,
+			dwarf::DW_AT::containing_type, dwarf::DW_AT::data_member_location,
+			dwarf::DW_AT::declaration, dwarf::DW_AT::specification, dwarf::DW_AT::abstract_origin,
+			dwarf::DW_AT::upper_bound, dwarf::DW_AT::virtuality, dwarf::DW_AT::signature };
+		static constexpr uint8_t NoSlot = 0xff;
+
+		/// @param attribute An attribute
+		/// @return The slot the attribute is decoded to, or NoSlot
+		static uint8_t GetSlot(dwarf::DW_AT attribute) noexcept;
+		/// @brief Decodes an attribute, unless it already was
+		/// @param attribute An attribute
+		/// @param slot The attribute's slot
+		/// @return The attribute, or an invalid value if the DIE doesn't have it
+		const dwarf::value& Load(dwarf::DW_AT attribute, uint8_t slot) const noexcept;
+
+		const dwarf::die& m_die;
+		mutable std::array<dwarf::value, Decoded.size()> m_values;
+		// a bit per slot that has been decoded
+		mutable uint32_t m_loaded = 0;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef DWARFTOCPP_BATCH_H_
+#define DWARFTOCPP_BATCH_H_
+
+/// @file
+/// Parsing Many ELF Files With Shared Types
+/// 10/16/26 21:05
+
+// DWARFToCPP includes
+#include <DWARFToCPP/Parser.h>
+#include <DWARFToCPP/SectionLoader.h>
+#include <DWARFToCPP/SplitUnits.h>
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Parses many ELF files at once, such as a program and its
+	/// shared libraries. Classes and enums that are the same in many files
+	/// are parsed once, and printed once to a common header that the
+	/// header of each file includes
+	class Batch
+	{
+	public:
+		/// @param threadCount The number of threads to parse with, 0 for
+		/// one per hardware thread. They are split between the files
+		explicit Batch(size_t threadCount) noexcept;
+
+		/// @brief Only parses what matches a root in every file
+		/// @param pattern A glob pattern or a regular expression
+		/// @param regex Whether or not the pattern is a regular expression
+		void AddRoot(std::string_view pattern, bool regex) noexcept { m_roots.emplace_back(pattern, regex); }
+
+		/// @brief Loads and parses every file, several at a time
+		/// @param paths The paths of the ELF files
+		/// @return The error of the first file that failed, if any did
+		std::optional<std::string> Parse(const std::vector<std::string>& paths) noexcept;
+
+		/// @brief Prints common.h with everything at least two files share,
+		/// other than classes that need what isn't shared, and a header per
+		/// file with the rest, which includes common.h
+		/// @param directory The directory to print the headers to
+		/// @return The error, if one occurs
+		std::optional<std::string> PrintToDirectory(const std::string& directory) const noexcept;
+
+		/// @return What every file's parser did
+		ParseStatistics Statistics() const noexcept;
+	private:
+		/// @brief A file, kept loaded for as long as what was parsed
+		/// from it is printed
+		struct Input
+		{
+			std::string path;
+			elf::elf file;
+			std::shared_ptr<SectionLoader> loader;
+			dwarf::dwarf data;
+			SplitUnits splitUnits;
+			std::unique_ptr<Parser> parser;
+		};
+
+		/// @brief Loads and parses one file
+		/// @param input The file
+		/// @param threadCount The number of threads to parse it with
+		/// @return The error, if one occurs
+		std::optional<std::string> ParseInput(Input& input, size_t threadCount) noexcept;
+
+		/// @brief Finds what a class needs to be complete to be defined,
+		/// which is what it inherits and holds by value
+		/// @param classConcept The class
+		/// @param dependencies The concepts it needs
+		static void CollectDependencies(const Class& classConcept,
+			std::vector<const Named*>& dependencies) noexcept;
+
+		/// @brief Finds every printed concept of a namespace, with the
+		/// namespaces it is in
+		/// @param scope The namespace
+		/// @param namespaces The namespaces the namespace is in, including itself
+		/// @param concepts The concepts
+		static void CollectConcepts(const Namespace& scope, std::vector<std::string_view>& namespaces,
+			std::vector<std::pair<std::vector<std::string_view>, Named*>>& concepts) noexcept;
+
+		size_t m_threadCount;
+		std::vector<std::pair<std::string, bool>> m_roots;
+		// holds what the files share, and every name
+		Parser m_store;
+		std::vector<std::unique_ptr<Input>> m_inputs;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef DWARFTOCPP_BUFFEREDWRITER_H_
+#define DWARFTOCPP_BUFFEREDWRITER_H_
+
+/// @file
+/// Double-Buffered Asynchronous File Writer
+/// 10/16/26 16:40
+
+// STL includes
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief A stream buffer that fills one large buffer while a
+	/// background thread writes the other one to a file, so that
+	/// formatting output never waits on I/O unless both are full. A
+	/// regular file is only replaced if what was written differs, so
+	/// output that did not change keeps its timestamp
+	class BufferedWriter : public std::streambuf
+	{
+	public:
+		/// @param path The path of the file to write
+		/// @param bufferSize The size of each of the two buffers
+		explicit BufferedWriter(const std::string& path, size_t bufferSize = 1 << 22) noexcept;
+		BufferedWriter(const BufferedWriter&) = delete;
+		BufferedWriter& operator=(const BufferedWriter&) = delete;
+		~BufferedWriter();
+
+		/// @return Whether or not everything so far was written
+		bool Good() const noexcept;
+		/// @brief Writes everything that is buffered and closes the file
+		/// @return Whether or not everything was written
+		bool Close() noexcept;
+		/// @return Whether or not the closed file was left as it was,
+		/// since it already had what was written
+		bool Unchanged() const noexcept { return m_unchanged; }
+	protected:
+		int_type overflow(int_type ch) override;
+		std::streamsize xsputn(const char* str, std::streamsize count) override;
+		int sync() override;
+	private:
+		/// @brief Hands the filled buffer to the background thread, once
+		/// it is done with the previous one, and starts filling the other
+		void Swap() noexcept;
+		/// @brief Waits until the background thread is done writing
+		/// @param lock The held lock
+		void WaitForWrite(std::unique_lock<std::mutex>& lock) noexcept;
+		/// @brief Writes buffers handed to it until the file is closed
+		void WriteLoop() noexcept;
+
+		/// @param lhsPath The path of a file
+		/// @param rhsPath The path of another file
+		/// @return Whether or not the files have the same contents
+		static bool SameContents(const std::string& lhsPath, const std::string& rhsPath) noexcept;
+
+		std::FILE* m_file = nullptr;
+		// written to first when replacing a regular file, empty otherwise
+		std::string m_path;
+		std::string m_tempPath;
+		bool m_unchanged = false;
+		std::vector<char> m_buffers[2];
+		size_t m_activeBuffer = 0;
+		std::thread m_writeThread;
+		// guards everything below
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		// the buffer being written, if any
+		const char* m_pendingData = nullptr;
+		size_t m_pendingSize = 0;
+		bool m_closing = false;
+		bool m_failed = false;
+	};
+}
+
+#endif
\ No newline at end of file
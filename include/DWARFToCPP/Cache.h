@@ -0,0 +1,149 @@
+#ifndef DWARFTOCPP_CACHE_H_
+#define DWARFTOCPP_CACHE_H_
+
+/// @file
+/// Binary Cache Of Parsed Concepts
+/// 10/16/26 15:10
+
+// DWARFToCPP includes
+#include <DWARFToCPP/Parser.h>
+#include <DWARFToCPP/StringPool.h>
+
+// STL includes
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Identifies the contents of an ELF file. This is its build-id
+	/// if it has one, or a hash of its debug sections otherwise
+	/// @param file The ELF file
+	/// @param salt Anything else the parsed result depends on
+	/// @return The key, as a hex string
+	std::string GetCacheKey(const elf::elf& file, std::string_view salt = {}) noexcept;
+
+	/// @brief Fingerprints a compilation unit by its bytes in .debug_info,
+	/// the abbreviation table it uses and the strings it references
+	/// @param file The ELF file
+	/// @param unitOffset The offset of the unit in .debug_info
+	/// @param salt Anything else the parsed unit depends on
+	/// @return The fingerprint, as a hex string, if the unit could be read
+	std::optional<std::string> GetUnitKey(const elf::elf& file,
+		dwarf::section_offset unitOffset, std::string_view salt = {}) noexcept;
+	/// @brief Hashes the bytes of a unit in .debug_info, which stay the
+	/// same when other units change or move
+	/// @param file The ELF file
+	/// @param unitOffset The offset of the unit in .debug_info
+	/// @return The hash, as a hex string, if the unit could be read
+	std::optional<std::string> GetUnitHash(const elf::elf& file,
+		dwarf::section_offset unitOffset) noexcept;
+
+	/// @brief Writes named concepts and the references between them.
+	/// Each concept is given an index when it is first referenced, and
+	/// concepts are serialized in index order
+	class CacheWriter
+	{
+	public:
+		/// @brief Writes an unsigned integer
+		/// @param value The integer
+		void Write(uint64_t value) noexcept;
+		/// @brief Writes a signed integer
+		/// @param value The integer
+		void WriteSigned(int64_t value) noexcept;
+		/// @brief Writes a string. Each distinct string is only stored once
+		/// @param str The string
+		void WriteString(InternedString str) noexcept;
+		/// @brief Writes a reference to a named concept, which is queued
+		/// to be serialized if it has not been yet
+		/// @param named The concept, or nullptr
+		void WriteReference(const Named* named) noexcept;
+
+		/// @param index The index of a concept
+		/// @return The concept
+		const Named* GetNode(size_t index) const noexcept { return m_nodes[index]; }
+		/// @return The number of concepts referenced so far
+		size_t NodeCount() const noexcept { return m_nodes.size(); }
+		/// @param named A concept
+		/// @return Whether or not the concept was referenced
+		bool Contains(const Named* named) const noexcept { return m_nodeIndices.contains(named); }
+
+		/// @brief Writes the cache file
+		/// @param path The path of the file
+		/// @param key The key of the cache
+		/// @return The error, if one occurs
+		std::optional<std::string> Finish(const std::string& path, std::string_view key) const noexcept;
+	private:
+		std::string m_payload;
+		std::vector<const Named*> m_nodes;
+		std::unordered_map<const Named*, uint64_t> m_nodeIndices;
+		std::vector<InternedString> m_strings;
+		std::unordered_map<InternedString, uint64_t, InternedString::Hasher> m_stringIndices;
+	};
+
+	/// @brief Reads what a CacheWriter wrote. Once anything is read out
+	/// of bounds, every read returns a default value and Error reports it
+	class CacheReader
+	{
+	public:
+		/// @param strings The pool to intern strings in
+		explicit CacheReader(StringPool& strings) noexcept :
+			m_strings(strings) {}
+
+		/// @brief Reads the cache file, up to the concepts
+		/// @param path The path of the file
+		/// @param key The expected key of the cache
+		/// @return The error, if the file could not be read or has another key
+		std::optional<std::string> Open(const std::string& path, std::string_view key) noexcept;
+
+		/// @return An unsigned integer
+		uint64_t Read() noexcept;
+		/// @return A signed integer
+		int64_t ReadSigned() noexcept;
+		/// @return The number of elements that follow, each of which
+		/// takes at least one byte
+		uint64_t ReadCount() noexcept;
+		/// @return An interned string
+		InternedString ReadString() noexcept;
+		/// @tparam T The type of the concept
+		/// @return The referenced concept, or nullptr
+		template<typename T>
+		T* ReadReference() noexcept
+		{
+			const auto named = ReadNode();
+			if (named == nullptr)
+				return nullptr;
+			const auto result = dynamic_cast<T*>(named);
+			if (result == nullptr)
+				m_failed = true;
+			return result;
+		}
+
+		/// @return The kind of each concept. A kind is the concept's
+		/// type, followed by its type code if it is typed
+		const std::vector<std::pair<Named::Type, Typed::TypeCode>>& NodeKinds() const noexcept { return m_nodeKinds; }
+		/// @param nodes The concept at each index
+		void SetNodes(std::vector<Named*> nodes) noexcept { m_nodes = std::move(nodes); }
+
+		/// @return The error, if anything was read out of bounds
+		std::optional<std::string> Error() const noexcept;
+	private:
+		/// @return A string stored in place
+		std::string_view ReadView() noexcept;
+		/// @return The referenced concept, or nullptr
+		Named* ReadNode() noexcept;
+
+		StringPool& m_strings;
+		std::string m_data;
+		size_t m_offset = 0;
+		bool m_failed = false;
+		std::vector<InternedString> m_stringTable;
+		std::vector<std::pair<Named::Type, Typed::TypeCode>> m_nodeKinds;
+		std::vector<Named*> m_nodes;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef DWARFTOCPP_DIEMEMO_H_
+#define DWARFTOCPP_DIEMEMO_H_
+
+/// @file
+/// Values Memoized by DIE
+/// 10/16/26 23:40
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+// DWARFToCPP includes
+#include <DWARFToCPP/OffsetMap.h>
+
+namespace DWARFToCPP
+{
+	/// @brief Maps DIEs to values. Offsets are only unique within the
+	/// section of a unit, since type units and split units reuse them,
+	/// so each unit gets a number above bit 40 of the key
+	/// @tparam T The type of the values
+	template<typename T>
+	class DIEMemo
+	{
+	public:
+		/// @brief Makes room for a number of values without rehashing
+		/// @param count The number of values
+		void Reserve(size_t count) noexcept { m_values.Reserve(count); }
+
+		/// @param unit The unit of a DIE
+		/// @param offset The DIE's offset in the unit's section
+		/// @return The key of the DIE
+		uint64_t GetKey(const dwarf::unit& unit, dwarf::section_offset offset) noexcept
+		{
+			// most DIEs are in the last unit
+			if (&unit != m_lastUnit)
+			{
+				m_lastUnit = &unit;
+				m_lastUnitIndex = m_unitIndices.try_emplace(&unit, m_unitIndices.size()).first->second;
+			}
+			return (m_lastUnitIndex << 40) | offset;
+		}
+
+		/// @param key A key from GetKey
+		/// @return The value of the key, or nullptr if it has none
+		T* Find(uint64_t key) noexcept { return m_values.Find(key); }
+
+		/// @brief Adds a value, unless the key already has one
+		/// @param key A key from GetKey
+		/// @param value The value
+		/// @return The key's value, and whether or not it was added
+		std::pair<T*, bool> Emplace(uint64_t key, T value) noexcept
+		{
+			return m_values.Emplace(key, std::move(value));
+		}
+
+		/// @return The number of values
+		size_t Size() const noexcept { return m_values.Size(); }
+		/// @brief Calls a function with every value, in the order they were added
+		/// @param func The function
+		template<typename Func>
+		void ForEach(Func&& func) noexcept { m_values.ForEach(std::forward<Func>(func)); }
+	private:
+		OffsetMap<T> m_values;
+		// the number of each unit in keys
+		std::unordered_map<const dwarf::unit*, uint64_t> m_unitIndices;
+		const dwarf::unit* m_lastUnit = nullptr;
+		uint64_t m_lastUnitIndex = 0;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef DWARFTOCPP_NAMEINDEX_H_
+#define DWARFTOCPP_NAMEINDEX_H_
+
+/// @file
+/// Index Of Fully Qualified Names
+/// 10/16/26 17:50
+
+// DWARFToCPP includes
+#include <DWARFToCPP/Parser.h>
+
+// STL includes
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Maps fully qualified names, like "ns::Outer::Inner", to
+	/// concepts. Namespaces and everything in them are indexed, as are
+	/// the types nested in classes. Built once after parsing, and not
+	/// updated if the namespaces change afterwards
+	class NameIndex
+	{
+	public:
+		struct Entry
+		{
+			std::string_view name;
+			const Named* named;
+			size_t hash;
+			// the concepts directly in this one, as a range of entries
+			uint32_t childBegin;
+			uint32_t childEnd;
+		};
+
+		/// @brief Indexes every name in a global namespace, replacing
+		/// whatever was indexed before
+		/// @param globalNamespace The global namespace
+		void Build(const Namespace& globalNamespace) noexcept;
+
+		/// @param qualifiedName A fully qualified name
+		/// @return The concept with the name, or nullptr if there is none
+		const Named* Find(std::string_view qualifiedName) const noexcept;
+		/// @param scope The qualified name of a namespace or class, or
+		/// an empty name for the global namespace
+		/// @return The concepts directly in the scope, in no particular order
+		std::span<const Entry> GetChildren(std::string_view scope) const noexcept;
+		/// @brief Calls a function for every name that starts with a prefix,
+		/// in sorted order. "ns::" visits everything in ns and below it
+		/// @tparam Func The type of the function
+		/// @param prefix The prefix
+		/// @param func The function, which is passed each entry
+		template<typename Func>
+		void ForEachWithPrefix(std::string_view prefix, Func&& func) const noexcept
+		{
+			for (auto sortedIt = LowerBound(prefix); sortedIt != m_sorted.end(); ++sortedIt)
+			{
+				const auto& entry = m_entries[*sortedIt];
+				if (entry.name.starts_with(prefix) == false)
+					break;
+				func(entry);
+			}
+		}
+
+		/// @return The number of indexed names
+		size_t Size() const noexcept { return m_entries.size(); }
+	private:
+		/// @param qualifiedName A fully qualified name
+		/// @return The index of its entry, or none
+		uint32_t FindEntry(std::string_view qualifiedName) const noexcept;
+		/// @param prefix A prefix
+		/// @return The first sorted entry that is not less than the prefix
+		std::vector<uint32_t>::const_iterator LowerBound(std::string_view prefix) const noexcept;
+
+		static constexpr uint32_t None = UINT32_MAX;
+
+		// each scope's children are next to each other, since scopes
+		// are expanded breadth first
+		std::vector<Entry> m_entries;
+		uint32_t m_globalEnd = 0;
+		// every qualified name, back to back
+		std::string m_names;
+		// entry indices ordered by name, for prefix searches
+		std::vector<uint32_t> m_sorted;
+		// an open-addressing table of entry indices with linear probing.
+		// its size is a power of two at least twice the entry count
+		std::vector<uint32_t> m_slots;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef DWARFTOCPP_OFFSETMAP_H_
+#define DWARFTOCPP_OFFSETMAP_H_
+
+/// @file
+/// Flat Hash Map Keyed by DIE Offsets
+/// 10/16/26 21:50
+
+// STL includes
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Maps 64-bit keys, such as DIE offsets, to values through an
+	/// open-addressing table of keys and value pointers, so a lookup
+	/// probes one contiguous array and touches nothing else. Values never
+	/// move once they are added
+	/// @tparam T The type of the values
+	template<typename T>
+	class OffsetMap
+	{
+	public:
+		/// @brief Makes room for a number of values without rehashing
+		/// @param count The number of values
+		void Reserve(size_t count) noexcept
+		{
+			// keep the table at most half full
+			const size_t slotCount = std::bit_ceil(std::max<size_t>(count * 2, MinSlots));
+			if (slotCount > m_slots.size())
+				Rehash(slotCount);
+		}
+
+		/// @param key A key
+		/// @return The value of the key, or nullptr if it has none
+		T* Find(uint64_t key) noexcept
+		{
+			if (m_slots.empty() == true)
+				return nullptr;
+			for (size_t slot = Hash(key);; slot = (slot + 1) & m_mask)
+			{
+				if (m_slots[slot].key == key)
+					return m_slots[slot].value;
+				if (m_slots[slot].key == EmptyKey)
+					return nullptr;
+			}
+		}
+
+		/// @brief Adds a value, unless the key already has one
+		/// @param key The key, which must not be the largest 64-bit value
+		/// @param value The value
+		/// @return The key's value, and whether or not it was added
+		std::pair<T*, bool> Emplace(uint64_t key, T value) noexcept
+		{
+			if ((m_values.size() + 1) * 2 > m_slots.size())
+				Rehash(std::max<size_t>(m_slots.size() * 2, MinSlots));
+			size_t slot = Hash(key);
+			for (; m_slots[slot].key != EmptyKey; slot = (slot + 1) & m_mask)
+			{
+				if (m_slots[slot].key == key)
+					return { m_slots[slot].value, false };
+			}
+			auto& added = m_values.emplace_back(std::move(value));
+			m_slots[slot] = Slot{ key, &added };
+			return { &added, true };
+		}
+
+		/// @return The number of values
+		size_t Size() const noexcept { return m_values.size(); }
+		/// @brief Calls a function with every value, in the order they were added
+		/// @param func The function
+		template<typename Func>
+		void ForEach(Func&& func) noexcept
+		{
+			for (auto& value : m_values)
+				func(value);
+		}
+	private:
+		struct Slot
+		{
+			uint64_t key = EmptyKey;
+			// indexing the deque costs more than the probe
+			T* value = nullptr;
+		};
+
+		static constexpr uint64_t EmptyKey = std::numeric_limits<uint64_t>::max();
+		static constexpr size_t MinSlots = 64;
+
+		/// @param key A key
+		/// @return The slot to start probing at
+		size_t Hash(uint64_t key) const noexcept
+		{
+			// offsets are dense, so mix the bits before masking them
+			return ((key * 0x9e3779b97f4a7c15) >> m_shift) & m_mask;
+		}
+
+		/// @brief Moves every key to a table of another size
+		/// @param slotCount The new number of slots, a power of 2
+		void Rehash(size_t slotCount) noexcept
+		{
+			std::vector<Slot> slots(slotCount);
+			std::swap(m_slots, slots);
+			m_mask = slotCount - 1;
+			m_shift = 64 - std::countr_zero(slotCount);
+			for (const auto& slot : slots)
+			{
+				if (slot.key == EmptyKey)
+					continue;
+				size_t newSlot = Hash(slot.key);
+				while (m_slots[newSlot].key != EmptyKey)
+					newSlot = (newSlot + 1) & m_mask;
+				m_slots[newSlot] = slot;
+			}
+		}
+
+		std::vector<Slot> m_slots;
+		// a deque so values never move as it grows
+		std::deque<T> m_values;
+		size_t m_mask = 0;
+		int m_shift = 64;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -16,12 +16,21 @@
 #include <tl/expected.hpp>
 
 // STL includes
-#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <ostream>
+#include <regex>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -29,9 +38,20 @@
 #pragma warning(pop)
 #endif
 
+// DWARFToCPP includes
+#include <DWARFToCPP/Arena.h>
+#include <DWARFToCPP/DIEMemo.h>
+#include <DWARFToCPP/Statistics.h>
+#include <DWARFToCPP/StringPool.h>
+
 namespace DWARFToCPP
 {
+	class Batch;
+	class CacheReader;
+	class CacheWriter;
 	class Parser;
+	class SplitUnits;
+	class TaskPool;
 
 	class Named
 	{
@@ -55,10 +75,25 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept = 0;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& /*parser*/) noexcept { return std::nullopt; }
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept = 0;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept = 0;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept = 0;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept = 0;
 	protected:
 		/// @param type The basic type of the named concept
 		Named(Type type) noexcept :
@@ -67,20 +102,20 @@ namespace DWARFToCPP
 		/// @brief Prints indents to the output file
 		/// @param outFile The indents
 		/// @param indentLevel The number of indents to print
-		static void PrintIndents(std::ofstream& outFile, size_t indentLevel) noexcept;
+		static void PrintIndents(std::ostream& outFile, size_t indentLevel) noexcept;
 	public:
 		/// @return The basic type of the named concept
 		Type GetType() const noexcept { return m_type; }
 		/// @return The name of the concept
-		const std::string& GetName() const noexcept { return m_name; }
+		std::string_view GetName() const noexcept { return m_name.View(); }
+		/// @return The interned name of the concept
+		InternedString GetInternedName() const noexcept { return m_name; }
 	protected:
-		/// @tparam Str The string type
 		/// @param name The name of the concept
-		template<typename Str>
-		void SetName(Str&& name) noexcept { m_name = std::forward<Str>(name); }
+		void SetName(InternedString name) noexcept { m_name = name; }
 	private:
 		Type m_type;
-		std::string m_name;
+		InternedString m_name;
 	};
 
 	class Enum;
@@ -103,7 +138,16 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 
 		/// @return The value of the enum
 		const std::variant<uint64_t, int64_t>& GetValue() const noexcept { return m_value; }
@@ -126,7 +170,16 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	};
 
 	class Namespace : public Named
@@ -140,7 +193,22 @@ namespace DWARFToCPP
 		/// @param named The named concept
 		/// @return The error, if applicable
 		std::optional<std::string> AddNamed(Parser& parser,
-			std::shared_ptr<Named> named) noexcept;
+			Named* named) noexcept;
+		/// @brief Adds a named concept that is about to be printed and
+		/// freed. Namespaces are copied, and the parser only keeps the
+		/// names of the other concepts, which aren't in the namespace
+		/// @param parser The parser that owns this namespace
+		/// @param unitParser The parser that owns the concept
+		/// @param named The named concept
+		/// @param emitted The namespace to add everything that was new to,
+		/// which is owned by the unit parser
+		/// @return The error, if applicable
+		std::optional<std::string> AddStreamed(Parser& parser, Parser& unitParser,
+			Named* named, Namespace& emitted) noexcept;
+		/// @brief Keys every concept whose name changed since it was added
+		/// by its current name again
+		/// @param parser The parser
+		void RekeyConcepts(Parser& parser) noexcept;
 
 		/// @brief Parses a DIE to a named concept
 		/// @param parser The parser
@@ -149,18 +217,50 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 
 		/// @brief Finds a named concept in the namespace
 		/// @param name The name of the concept
-		/// @return The concept
-		std::optional<std::shared_ptr<const Named>> GetNamedConcept(
-			const std::string& name) const noexcept;
+		/// @return The concept, or nullptr if there is none
+		const Named* GetNamedConcept(InternedString name) const noexcept;
+		/// @return Every named concept in the namespace
+		const std::unordered_map<InternedString, Named*, InternedString::Hasher>&
+			GetNamedConcepts() const noexcept { return m_namedConcepts; }
+		/// @return Every named concept in the namespace, sorted by name so
+		/// that output is the same every run
+		std::vector<std::pair<InternedString, Named*>> GetSortedConcepts() const noexcept;
+
+		/// @param named A named concept in a namespace
+		/// @return Whether or not the concept is printed with its namespace
+		static bool IsPrinted(const Named& named) noexcept;
 	private:
-		std::unordered_map<std::string, std::weak_ptr<Named>> m_namedConcepts;
+		/// @param named A named concept
+		/// @param existing The concept of the same name in the namespace
+		/// @return Whether or not the concept replaces the existing one,
+		/// which is when it defines a class the existing one only declares
+		static bool Supersedes(const Named& named, const Named& existing) noexcept;
+
+		std::unordered_map<InternedString, Named*, InternedString::Hasher> m_namedConcepts;
+		// children are added once they are named
+		std::vector<Named*> m_children;
 	};
 
 	class SubProgram : public Named
@@ -175,14 +275,32 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
 		bool m_virtual = false;
-		std::optional<std::weak_ptr<Typed>> m_returnType;
-		std::vector<std::weak_ptr<Value>> m_parameters;
+		// nullptr if the return type is void
+		Typed* m_returnType = nullptr;
+		std::vector<Value*> m_parameters;
+		// the function this specifies, if this is a specification
+		SubProgram* m_specified = nullptr;
 	};
 
 	class Typed : public Named
@@ -227,18 +345,33 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 
 		/// @return The size of the array, in elements
 		size_t Size() const noexcept { return m_size; }
 		/// @return The type of the array
-		const std::weak_ptr<Typed>& Type() const noexcept { return m_type; }
+		const Typed* Type() const noexcept { return m_type; }
 	private:
 		size_t m_size = 0;
-		std::weak_ptr<Typed> m_type;
+		Typed* m_type = nullptr;
 	};
 
 	class BasicType : public Typed
@@ -256,7 +389,16 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	};
 
 	class Class : public Typed
@@ -281,15 +423,33 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
+
+		/// @return The members of the class, and their accessibility
+		const std::vector<std::pair<Named*, Accessibility>>& GetMembers() const noexcept { return m_members; }
+		/// @return Whether or not the class was only declared, and is
+		/// defined in another unit
+		bool IsDeclaration() const noexcept { return m_declaration; }
+		/// @return The classes the class inherits, and their accessibility
+		const std::vector<std::pair<Class*, Accessibility>>& GetParentClasses() const noexcept { return m_parentClasses; }
 	protected:
 		static std::string ToString(Accessibility accessibility) noexcept;
 		static std::string ToString(dwarf::DW_TAG classsType) noexcept;
 
 		dwarf::DW_TAG m_classType{};
-		std::vector<std::pair<std::weak_ptr<Named>, Accessibility>> m_members;
-		std::vector<std::pair<std::weak_ptr<Class>, Accessibility>> m_parentClasses;
-		std::vector<std::weak_ptr<Value>> m_templateParameters;
+		bool m_declaration = false;
+		std::vector<std::pair<Named*, Accessibility>> m_members;
+		std::vector<std::pair<Class*, Accessibility>> m_parentClasses;
+		std::vector<Value*> m_templateParameters;
 	};
 
 	class ConstType : public Typed
@@ -304,12 +464,31 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
+
+		/// @return The type that is const, or nullptr if it is void
+		const Named* Type() const noexcept { return m_type; }
 	private:
-		std::optional<std::weak_ptr<Named>> m_type;
+		// nullptr if the type is void
+		Named* m_type = nullptr;
 	};
 
 	class Enum : public Typed
@@ -327,9 +506,18 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::vector<std::weak_ptr<Enumerator>> m_enumerators;
+		std::vector<Enumerator*> m_enumerators;
 	};
 
 	class NamedType : public Typed
@@ -347,9 +535,18 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::optional<std::weak_ptr<Typed>> m_type;
+		Typed* m_type = nullptr;
 	};
 
 	class Pointer : public Typed
@@ -364,12 +561,28 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::optional<std::weak_ptr<Named>> m_type;
+		// nullptr if the type is void
+		Named* m_type = nullptr;
 	};
 
 	class PointerToMember : public Typed
@@ -387,10 +600,19 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::weak_ptr<Class> m_containingType;
-		std::weak_ptr<Subroutine> m_functionType;
+		Class* m_containingType = nullptr;
+		Subroutine* m_functionType = nullptr;
 	};
 
 	class RefType : public Typed
@@ -405,18 +627,33 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::weak_ptr<Named> m_type;
+		Named* m_type = nullptr;
 	};
 
 	class RRefType : public Typed
 	{
 	public:
-		RRefType() noexcept : Typed(TypeCode::RefType) {}
+		RRefType() noexcept : Typed(TypeCode::RRefType) {}
 
 		/// @brief Parses a DIE to a named concept
 		/// @param parser The parser
@@ -425,12 +662,27 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::weak_ptr<Named> m_type;
+		Named* m_type = nullptr;
 	};
 
 	/// @brief Subroutine is like a subprogram,
@@ -447,13 +699,29 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
-		std::optional<std::weak_ptr<Typed>> m_returnType;
-		std::vector<std::weak_ptr<Value>> m_parameters;
+		// nullptr if the return type is void
+		Typed* m_returnType = nullptr;
+		std::vector<Value*> m_parameters;
 	};
 
 	class TypeDef : public Typed
@@ -471,9 +739,21 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
+
+		/// @return The type that is aliased
+		const Typed* Type() const noexcept { return m_type; }
 	private:
-		std::weak_ptr<Typed> m_type;
+		Typed* m_type = nullptr;
 	};
 
 	class VolatileType : public Typed
@@ -488,12 +768,30 @@ namespace DWARFToCPP
 		virtual std::optional<std::string> ParseDIE(Parser& parser,
 			const dwarf::die& die) noexcept;
 
+		/// @brief Finishes a named concept once everything its DIE
+		/// references has been parsed
+		/// @param parser The parser
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Finalize(Parser& parser) noexcept;
+
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
+
+		/// @return The type that is volatile
+		const Named* Type() const noexcept { return m_type; }
 	private:
-		std::weak_ptr<Named> m_type;
+		Named* m_type = nullptr;
 	};
 
 	class Value : public Named
@@ -501,7 +799,7 @@ namespace DWARFToCPP
 	public:
 		Value() noexcept : Named(Type::Value) {}
 
-		const std::weak_ptr<Typed>& GetValueType() const noexcept { return m_type; }
+		const Typed* GetValueType() const noexcept { return m_type; }
 
 		/// @brief Parses a DIE to a named concept
 		/// @param parser The parser
@@ -513,34 +811,162 @@ namespace DWARFToCPP
 		/// @brief Prints the named type to a file
 		/// @param outFile The output file
 		/// @param indentLevel The indentation level
-		virtual void PrintToFile(std::ofstream& outFile, size_t indentLevel = 0) noexcept;
+		virtual void PrintToFile(std::ostream& outFile, size_t indentLevel = 0) noexcept;
+
+		/// @brief Writes the named concept to a cache
+		/// @param writer The cache writer
+		virtual void Serialize(CacheWriter& writer) const noexcept;
+
+		/// @brief Reads the named concept from a cache
+		/// @param reader The cache reader
+		/// @return The error, if applicable
+		virtual std::optional<std::string> Deserialize(CacheReader& reader) noexcept;
 	private:
 		/// @tparam Str The string type
 		/// @param type The type of the value
 		/// @param name The name of the value
 		template<typename Str>
-		Value(std::shared_ptr<Typed> type, Str&& name) noexcept :
+		Value(Typed* type, Str&& name) noexcept :
 			Named(Named::Type::Value, std::forward<Str>(name)),
-			m_type(std::move(type)) {}
+			m_type(type) {}
 
-		std::weak_ptr<Typed> m_type;
+		Typed* m_type = nullptr;
 	};
 
 	class Parser
 	{
 	public:
+		/// @param threadCount The number of threads to parse compilation
+		/// units with. 0 uses one thread per hardware thread
+		explicit Parser(size_t threadCount = 1) noexcept :
+			m_threadCount(threadCount) {}
+
 		/// @brief Parses the global namespace from parsed DWARF data,
 		/// and stores all classes, namespaces, and instances from the data
 		/// @param data The parsed DWARF data
 		/// @return The error, if one occurs
 		std::optional<std::string> ParseDWARF(const dwarf::dwarf& data) noexcept;
+		/// @brief Parses DWARF data like ParseDWARF, but prints the new
+		/// classes and namespaces of each compilation unit as soon as it
+		/// and every unit before it is parsed, then frees the unit. The
+		/// global namespace only has namespaces afterwards, and classes
+		/// are not shared between units, so equal classes from different
+		/// units are not merged by their ODR key
+		/// @param data The parsed DWARF data
+		/// @param outFile The output file
+		/// @return The error, if one occurs
+		std::optional<std::string> StreamDWARF(const dwarf::dwarf& data, std::ostream& outFile) noexcept;
+		/// @brief Restricts parsing to the concepts whose qualified name
+		/// matches a root pattern, and everything they reference through
+		/// types, inheritance and members. A matching namespace includes
+		/// everything in it. Without any roots, everything is parsed
+		/// @param pattern A glob pattern, where * matches any sequence
+		/// and ? any character, or a regular expression
+		/// @param regex Whether or not the pattern is a regular expression
+		/// @return The error, if the pattern is invalid
+		std::optional<std::string> AddRoot(std::string_view pattern, bool regex = false) noexcept;
 
 		/// @brief Prints all classes and namespaces to a file
 		/// @param outFile The output file
-		void PrintToFile(std::ofstream& outFile) noexcept;
+		void PrintToFile(std::ostream& outFile) noexcept;
+		/// @brief Prints one header per top-level namespace, or per class,
+		/// and an umbrella header that includes every other header. Each
+		/// header includes the headers that define what it references, and
+		/// the headers are printed in parallel
+		/// @param directory The directory to print the headers to
+		/// @param perClass Whether or not each class gets its own header
+		/// @return The error, if one occurs
+		std::optional<std::string> PrintToDirectory(const std::string& directory,
+			bool perClass = false) noexcept;
+
+		/// @brief Writes every parsed concept to a cache file
+		/// @param path The path of the cache file
+		/// @param key The key of the parsed data, from GetCacheKey
+		/// @return The error, if one occurs
+		std::optional<std::string> SaveCache(const std::string& path, std::string_view key) const noexcept;
+		/// @brief Loads the parsed concepts from a cache file instead
+		/// of parsing DWARF data. The parser must not have parsed anything
+		/// @param path The path of the cache file
+		/// @param key The key of the parsed data, from GetCacheKey
+		/// @return The error, if the cache is missing, corrupt, or has another key
+		std::optional<std::string> LoadCache(const std::string& path, std::string_view key) noexcept;
+		/// @brief Caches each parsed compilation unit in a directory, keyed
+		/// by a fingerprint of its DWARF data. Units that are already
+		/// cached are loaded instead of parsed, so after a rebuild only
+		/// the units that changed are parsed again
+		/// @param directory The directory to cache units in
+		/// @param file The ELF file the DWARF data is loaded from, which
+		/// must outlive parsing
+		void SetUnitCache(std::string directory, const elf::elf& file) noexcept;
+		/// @brief A unit that could not be cached is parsed again on the
+		/// next run, but doesn't stop this one
+		/// @return Why the first unit could not be cached, if one couldn't
+		const std::optional<std::string>& UnitCacheError() const noexcept { return m_unitCacheError; }
+		/// @brief Tells the parser which ELF file the DWARF data is loaded
+		/// from, so the statistics include the size of every unit. When
+		/// every root is an exact name, the units that define them are
+		/// found through the file's accelerator tables, and only those
+		/// units are parsed, along with the units that define the classes
+		/// they only declare
+		/// @param file The ELF file, which must outlive parsing
+		void SetFile(const elf::elf& file) noexcept;
+		/// @brief Parses the split units of a file built with -gsplit-dwarf
+		/// instead of their skeleton units
+		/// @param splitUnits The split units, which must outlive parsing
+		void SetSplitUnits(const SplitUnits& splitUnits) noexcept { m_splitUnits = &splitUnits; }
+		/// @brief Shares classes and enums with every other parser that
+		/// shares them with the same store, so types that are the same in
+		/// many files are parsed once. Names are interned in the store
+		/// @param store A parser that only holds what is shared, which must
+		/// outlive this one and everything it parsed
+		void ShareTypes(Parser& store) noexcept { m_typeStore = &store; }
+		/// @brief Bounds the memory used while parsing. Units are parsed a
+		/// window at a time, which is streamed or merged before the next
+		/// starts, and the window shrinks while the resident set is over
+		/// the budget. Functions and variables, which are never printed,
+		/// are skipped. ParseDWARF keeps every merged type, so only
+		/// StreamDWARF frees each window and bounds the memory of files
+		/// larger than memory
+		/// @param bytes The peak resident set to stay under, or 0 for no bound
+		void SetMemoryBudget(size_t bytes) noexcept { m_memoryBudget = bytes; }
+
+		/// @brief How DIEs with a tag are made into concepts
+		struct TagHandler
+		{
+			// makes the concept in a parser's arena
+			Named* (*create)(Arena& arena) noexcept;
+			// parses the DIE into the concept, like its ParseDIE
+			std::optional<std::string> (*parse)(Named& named, Parser& parser,
+				const dwarf::die& die) noexcept;
+		};
+
+		/// @tparam T The concept to make
+		/// @return A handler that makes a T, and parses it without a virtual call
+		template<typename T>
+		static constexpr TagHandler MakeHandler() noexcept
+		{
+			return TagHandler{
+				[](Arena& arena) noexcept -> Named* { return arena.Create<T>(); },
+				[](Named& named, Parser& parser, const dwarf::die& die) noexcept
+				{
+					return static_cast<T&>(named).T::ParseDIE(parser, die);
+				} };
+		}
+		/// @brief Handles DIEs with a tag, such as a vendor tag, in place
+		/// of the built-in handler if there is one. Unit parsers use the
+		/// handlers of the parser that made them, so this must be called
+		/// before parsing
+		/// @param tag The tag
+		/// @param handler The handler, such as one from MakeHandler. The
+		/// concept must be one the cache can make, to be cached
+		void RegisterHandler(dwarf::DW_TAG tag, TagHandler handler) noexcept { m_handlers[tag] = handler; }
 
 		/// @return The global namespace
 		const Namespace& GlobalNamespace() const noexcept { return m_globalNamespace; }
+		/// @return The pool every parsed name is interned in
+		const StringPool& Strings() const noexcept { return (m_typeStore != nullptr) ? m_typeStore->m_strings : m_strings; }
+		/// @return What the parser did, and where its time went
+		const ParseStatistics& Statistics() const noexcept { return m_statistics; }
 	private:
 		// friend each type so they can parse on their own
 		// which may require additional parsing from the parser
@@ -549,6 +975,7 @@ namespace DWARFToCPP
 		friend Class;
 		friend ConstType;
 		friend Enum;
+		friend Enumerator;
 		friend NamedType;
 		friend Namespace;
 		friend Pointer;
@@ -560,20 +987,365 @@ namespace DWARFToCPP
 		friend TypeDef;
 		friend Value;
 		friend VolatileType;
+		// batches print what parsers share on its own
+		friend Batch;
+
+		struct Frame;
+
+		enum class EntryState
+		{
+			// requested, but its DIE has not been parsed yet
+			Queued,
+			// its DIE was parsed, but it is waiting on what it references
+			Parsing,
+			Parsed
+		};
+
+		struct ParsedEntry
+		{
+			Named* named;
+			// the thread that is parsing the entry
+			std::thread::id parsingThread;
+			EntryState state = EntryState::Queued;
+			// the frame that will parse the entry while it is queued
+			Frame* frame = nullptr;
+			// how the entry is parsed, until it is
+			const TagHandler* handler = nullptr;
+		};
+
+		/// @brief Identifies a class or enum definition across units
+		struct OdrKey
+		{
+			InternedString qualifiedName;
+			uint64_t structuralHash;
+
+			bool operator==(const OdrKey& other) const noexcept = default;
+		};
+
+		struct OdrKeyHasher
+		{
+			size_t operator()(const OdrKey& key) const noexcept
+			{
+				return key.qualifiedName.Hash() ^ (key.structuralHash * 0x9e3779b97f4a7c15);
+			}
+		};
+
+		/// @brief A DIE on a thread's traversal stack. Each frame is
+		/// visited twice: once to parse its DIE, which queues everything
+		/// it references above it, and once more to finalize it after
+		/// they have been parsed
+		struct Frame
+		{
+			// nullptr for the bottom frame of a traversal
+			ParsedEntry* entry;
+			dwarf::die die;
+			bool expanded = false;
+			std::optional<OdrKey> odrKey;
+			// the entries the DIE referenced
+			std::vector<ParsedEntry*> dependencies;
+		};
+
+		/// @brief The explicit stack a thread parses DIEs with, so that
+		/// deeply nested DIEs do not overflow the call stack
+		struct Traversal
+		{
+			Parser* parser;
+			// frames do not move while they are on the stack
+			std::deque<Frame> frames;
+			// the entries requested by the DIE being parsed
+			std::vector<Frame> requested;
+		};
+
+		/// @brief A header printed by PrintToDirectory
+		struct OutputHeader
+		{
+			// relative to the output directory
+			std::string path;
+			// the namespaces the concepts are in, outermost first
+			std::vector<std::string_view> namespaces;
+			std::vector<Named*> concepts;
+			// the headers that define what the concepts reference,
+			// relative to this one
+			std::vector<std::string> includes;
+		};
+
+		/// @brief Creates a parser for a single compilation unit
+		/// @param owner The parser the unit will be merged into
+		explicit Parser(Parser& owner) noexcept :
+			m_owner(&owner), m_threadCount(1) {}
+
+		/// @brief Interns a string in the owning parser's pool
+		/// @param str The string
+		/// @return The interned string
+		InternedString Intern(std::string_view str) noexcept;
+		/// @return The pool the owning parser interns names in
+		StringPool& GetStringPool() noexcept;
+		/// @brief Names an anonymous class or enum after where its DIE is
+		/// in its unit, so it is named the same every run and wherever
+		/// the unit is in the file
+		/// @param die The DIE
+		/// @return The name
+		std::string GetAnonymousName(const dwarf::die& die) noexcept;
 
 		/// @brief Adds a child-parent relationship
 		/// @param child The child node
 		/// @param parent The parent node
 		void AddParent(const Named& child, const Named& parent) noexcept;
 
-		/// @brief Parses a single compliation unit
+		/// @brief Parses a single compliation unit into this parser's
+		/// entries. Each top-level DIE is queued as its own task, and
+		/// the results are stored in order so they can later be merged
+		/// into another parser
 		/// @param unit The compilation unit to parse
+		/// @param pool The pool to queue tasks to
+		void ParseCompilationUnit(const dwarf::compilation_unit& unit, TaskPool& pool) noexcept;
+		/// @brief Loads a compilation unit from the unit cache, if it
+		/// has not changed since it was cached
+		/// @param unit The compilation unit
+		/// @return Whether or not the unit was loaded
+		bool LoadCompilationUnit(const dwarf::compilation_unit& unit) noexcept;
+		/// @brief Caches a parsed compilation unit
+		/// @return An error message, if the unit could not be cached
+		std::optional<std::string> SaveCompilationUnit() const noexcept;
+		/// @return The path a compilation unit is cached at
+		std::string UnitCachePath() const noexcept;
+		/// @brief Parses units a window at a time, to stay under the
+		/// memory budget
+		/// @param units The units to parse
+		/// @param unitBytes The size of each unit
+		/// @param splitUnits Whether or not each unit is a split unit
+		/// @return The error, if one occurs
+		std::optional<std::string> ParseInWindows(const std::vector<const dwarf::compilation_unit*>& units,
+			const std::vector<size_t>& unitBytes, const std::vector<bool>& splitUnits) noexcept;
+		/// @brief Queues a unit to be parsed, or loaded from the unit cache
+		/// @param pool The pool to parse the unit on
+		/// @param unitParser The parser of the unit
+		/// @param unit The unit
+		/// @param bytes The size of the unit, to size its memo by
+		/// @param cacheable Whether or not the unit may be in the unit cache
+		static void PushCompilationUnit(TaskPool& pool, Parser& unitParser,
+			const dwarf::compilation_unit& unit, size_t bytes, bool cacheable) noexcept;
+		/// @brief Caches, records, and streams or merges a parsed unit
+		/// @param unitParser The parser of the unit
+		/// @param unit The unit
+		/// @param bytes The size of the unit
+		/// @return The error, if one occurs
+		std::optional<std::string> FinishCompilationUnit(Parser& unitParser,
+			const dwarf::compilation_unit& unit, size_t bytes) noexcept;
+		/// @brief Runs a window of units, measuring the resident set
+		/// while they parse
+		/// @param pool The pool the window's units are queued on
+		/// @return The peak resident set, or 0 if it can't be measured
+		size_t RunWindow(TaskPool& pool) noexcept;
+		/// @return The anonymous part of the process's resident set, without
+		/// mapped files, or 0 if it can't be measured
+		static size_t GetResidentBytes() noexcept;
+		/// @brief Takes ownership of every type parsed from a type unit,
+		/// once every unit that references them is merged
+		void MergeTypeUnits() noexcept;
+		/// @brief Loads the type units, and each one's root and
+		/// abbreviations, which libelfin otherwise loads the first time
+		/// they are read without any synchronization
+		/// @param data The parsed DWARF data
+		void LoadTypeUnits(const dwarf::dwarf& data) const noexcept;
+		/// @brief Finds the type a DIE stands for in a type unit
+		/// @param die The DIE
+		/// @return The type's DIE, if the DIE is a declaration that names
+		/// its definition by signature
+		static std::optional<dwarf::die> ResolveSignature(const dwarf::die& die) noexcept;
+		/// @param die A DIE
+		/// @return Whether or not the DIE is in a type unit
+		static bool InTypeUnit(const dwarf::die& die) noexcept;
+		/// @brief Finds the units that define the roots through the
+		/// file's accelerator tables
+		/// @param units Every compilation unit, in order
+		/// @return The units to parse, in order. Every unit if there are
+		/// no roots, a root is a pattern, any root is not found, or the
+		/// units are streamed
+		std::vector<const dwarf::compilation_unit*> SelectUnits(
+			const std::vector<dwarf::compilation_unit>& units) const noexcept;
+		/// @brief Finds the units that define the classes the parsed units
+		/// only declare, and adds the classes to the roots. Limited debug
+		/// info only defines a class in the units that need its definition
+		/// @param units Every compilation unit, in order
+		/// @param parsedUnits The units that were parsed, which the
+		/// selected units are added to
+		/// @param lookedUp The names that were already looked up
+		/// @return The units to parse next, in order
+		std::vector<const dwarf::compilation_unit*> SelectDefiningUnits(
+			const std::vector<dwarf::compilation_unit>& units,
+			std::unordered_set<const dwarf::compilation_unit*>& parsedUnits,
+			std::unordered_set<std::string>& lookedUp) noexcept;
+		/// @brief Adds the qualified names of the declared classes in a
+		/// namespace and the namespaces in it
+		/// @param scope The namespace
+		/// @param prefix The qualified name of the namespace
+		/// @param names The names
+		static void CollectDeclarations(const Namespace& scope, const std::string& prefix,
+			std::vector<std::string>& names) noexcept;
+		/// @brief Parses a set of units and merges them
+		/// @param data The parsed DWARF data
+		/// @param selectedUnits The units, in order
 		/// @return The error, if one occurs
-		std::optional<std::string> ParseCompilationUnit(const dwarf::compilation_unit& unit) noexcept;
-		/// @brief Parses a DIE
+		std::optional<std::string> ParseUnits(const dwarf::dwarf& data,
+			std::vector<const dwarf::compilation_unit*> selectedUnits) noexcept;
+		/// @brief Marks one of a compilation unit's tasks as finished
+		void FinishTask() noexcept;
+		/// @brief Adds the time since a task started to the unit's parse time
+		/// @param start When the task started
+		void AddParseTime(std::chrono::steady_clock::time_point start) noexcept;
+		/// @brief Adds the time since a unit started merging to the merge time
+		/// @param start When the unit started merging
+		void AddMergeTime(std::chrono::steady_clock::time_point start) noexcept;
+		/// @brief Records the statistics of a finished compilation unit
+		/// @param unitParser The parser of the unit
+		/// @param unit The unit
+		/// @param bytes The size of the unit in .debug_info, 0 if it is unknown
+		void RecordUnit(const Parser& unitParser, const dwarf::compilation_unit& unit,
+			size_t bytes) noexcept;
+		/// @brief Waits until every task of a compilation unit is finished
+		/// @param unitParser The parser of the unit
+		void WaitForUnit(const Parser& unitParser) noexcept;
+		/// @brief Prints the concepts of a parsed compilation unit that
+		/// are not yet in the global namespace, and adds their names
+		/// @param unitParser The parser that parsed the unit
+		/// @return The error, if one occurs
+		std::optional<std::string> StreamCompilationUnit(Parser& unitParser) noexcept;
+		/// @brief Merges a parsed compilation unit into the global namespace,
+		/// taking ownership of all of its parsed entries
+		/// @param unitParser The parser that parsed the unit
+		/// @return The error, if one occurs
+		std::optional<std::string> MergeCompilationUnit(Parser& unitParser) noexcept;
+		/// @brief Parses a DIE. Safe to call from multiple threads. When
+		/// called while parsing another DIE, the returned concept is
+		/// only queued, and is parsed before that DIE is finalized
 		/// @param die The DIE
 		/// @return The parsed named concept from the DIE
-		tl::expected<std::shared_ptr<Named>, std::string> ParseDIE(const dwarf::die& die) noexcept;
+		tl::expected<Named*, std::string> ParseDIE(const dwarf::die& die) noexcept;
+		/// @param tag The tag of a DIE
+		/// @return The handler of DIEs with the tag, or nullptr if there is none
+		const TagHandler* FindHandler(dwarf::DW_TAG tag) const noexcept;
+		/// @brief Creates the concept for a DIE, and queues it to be
+		/// parsed by the traversal if nothing has yet
+		/// @param traversal The current thread's traversal
+		/// @param die The DIE
+		/// @return The concept for the DIE
+		tl::expected<Named*, std::string> RequestDIE(Traversal& traversal,
+			const dwarf::die& die) noexcept;
+		/// @brief Makes the current DIE depend on an existing entry
+		/// @param traversal The current thread's traversal
+		/// @param entry The entry
+		/// @param die The DIE of the entry
+		/// @return The concept of the entry
+		Named* RequestEntry(Traversal& traversal, ParsedEntry& entry,
+			const dwarf::die& die) noexcept;
+		/// @brief Parses and finalizes every frame of a traversal
+		/// @param traversal The traversal
+		/// @return The error, if one occurs
+		std::optional<std::string> RunTraversal(Traversal& traversal) noexcept;
+		/// @brief Pushes the entries requested by the last parsed DIE
+		/// @param traversal The traversal
+		void QueueRequested(Traversal& traversal) noexcept;
+		/// @brief Waits for the entries a frame depends on
+		/// @param traversal The current thread's traversal
+		/// @param frame The frame
+		/// @return Whether or not the frame can be finalized. If not,
+		/// an entry was taken over and pushed to the traversal
+		bool WaitForDependencies(Traversal& traversal, Frame& frame) noexcept;
+		/// @brief Marks every unfinished entry of a traversal as parsed
+		/// so that no other thread waits on them
+		/// @param traversal The traversal
+		void AbortTraversal(Traversal& traversal) noexcept;
+		/// @brief Records the qualified name of every class and enum
+		/// in a unit that is not inside of a function or anonymous scope
+		/// @param root The root DIE of the unit
+		void IndexScopes(const dwarf::die& root) noexcept;
+		/// @brief Finds the DIEs of a unit that match a root, and
+		/// marks them, their enclosing scopes, and every scope-level DIE
+		/// they transitively reference as wanted. Nothing is parsed
+		/// @param root The root DIE of the unit
+		void SelectRoots(const dwarf::die& root) noexcept;
+		/// @param die A DIE in a namespace
+		/// @return Whether or not the DIE should be parsed
+		bool IsWanted(const dwarf::die& die) const noexcept;
+		/// @param tag The tag of a DIE
+		/// @return Whether or not DIEs with the tag can be shared between units
+		static bool IsOdrCandidate(dwarf::DW_TAG tag) noexcept;
+		/// @brief Identifies a class or enum by its qualified name and a
+		/// hash of its structure, without parsing it
+		/// @param die The DIE
+		/// @return The key, if the DIE was indexed
+		std::optional<OdrKey> GetOdrKey(const dwarf::die& die) const noexcept;
+		/// @brief Finds a class or enum that any unit has parsed
+		/// @param key The key of the class or enum
+		/// @return The parsed concept, or nullptr if there is none
+		Named* FindOdrEntry(const OdrKey& key) noexcept;
+		/// @brief Shares a parsed class or enum with other units
+		/// @param key The key of the class or enum
+		/// @param named The parsed concept
+		void AddOdrEntry(OdrKey key, Named* named) noexcept;
+		/// @brief Waits for another thread to finish parsing an entry,
+		/// unless that thread is waiting on this one
+		/// @param lock The held parse lock
+		/// @param traversal The current thread's traversal
+		/// @param entry The entry
+		/// @return Whether or not the entry can be used. If not, it
+		/// was taken over and pushed to the traversal
+		bool WaitForEntry(std::unique_lock<std::mutex>& lock,
+			Traversal& traversal, ParsedEntry& entry) noexcept;
+		/// @param named A named concept
+		/// @return Whether or not the concept is named after the concepts
+		/// it references when it is finalized
+		static bool HasDerivedName(const Named& named) noexcept;
+		/// @brief Derives the names of every derived-name entry again until
+		/// none change, once every traversal is done. An entry used before
+		/// it was finalized, to break a reference cycle, may have lent its
+		/// name to others before it had one, and which entry that was
+		/// depends on which thread got there first. Namespaces are keyed
+		/// by the new names afterwards
+		void DeriveCycleNames() noexcept;
+
+		/// @brief Writes concepts and everything they reference to a cache
+		/// @param path The path of the cache file
+		/// @param key The key of the cache
+		/// @param roots The concepts
+		/// @return The error, if one occurs
+		std::optional<std::string> WriteCache(const std::string& path, std::string_view key,
+			const std::vector<const Named*>& roots) const noexcept;
+		/// @brief Reads concepts written by WriteCache into this parser
+		/// @param path The path of the cache file
+		/// @param key The expected key of the cache
+		/// @param globalNamespace The namespace to read the first concept
+		/// into if it is a namespace, or nullptr to allocate every concept
+		/// @return The concepts that were written, or the error
+		tl::expected<std::vector<Named*>, std::string> ReadCache(const std::string& path,
+			std::string_view key, Namespace* globalNamespace) noexcept;
+		/// @brief Creates an empty concept of a kind stored in a cache
+		/// @param type The type of the concept
+		/// @param typeCode The type code of the concept, if it is typed
+		/// @return The concept, or nullptr if the kind is invalid
+		Named* CreateNode(Named::Type type, Typed::TypeCode typeCode) noexcept;
+
+		/// @brief Finds the headers that define the concepts a header
+		/// references, so it can be included on its own
+		/// @param header The header
+		/// @param headers Every header
+		/// @param definedIn The header each printed concept is defined in
+		static void CollectIncludes(OutputHeader& header, const std::vector<OutputHeader>& headers,
+			const std::unordered_map<const Named*, size_t>& definedIn) noexcept;
+		/// @brief Prints the concepts of a header in their namespaces
+		/// @param outFile The output file
+		/// @param header The header
+		static void PrintHeader(std::ostream& outFile, const OutputHeader& header) noexcept;
+		/// @brief Finds the headers to print the concepts of a namespace to
+		/// @param scope The namespace
+		/// @param namespaces The namespaces the namespace is in, including itself
+		/// @param perClass Whether or not each class gets its own header
+		/// @param headers The headers
+		/// @param usedPaths The paths already taken by other headers
+		void CollectHeaders(const Namespace& scope, std::vector<std::string_view>& namespaces,
+			bool perClass, std::vector<OutputHeader>& headers,
+			std::unordered_set<std::string>& usedPaths) const noexcept;
 
 		/// @param named The named object to trace to the global namespace
 		/// @return the path to the global namespace
@@ -586,8 +1358,93 @@ namespace DWARFToCPP
 		// first time. store pointers to save space, same with parsed
 		// entries
 		std::unordered_map<const Named*, const Named*> m_childToParentMap;
-		// we also store parsed entries here
-		std::unordered_map<const void*, std::shared_ptr<Named>> m_parsedEntries;
+		// we also store parsed entries here, guarded by the parse mutex.
+		// the concepts are owned by the arena
+		DIEMemo<ParsedEntry> m_parsedEntries;
+		// the top-level concepts of a parsed compilation unit, in the
+		// order they appear so merging is deterministic, and the error
+		// each one produced
+		std::vector<Named*> m_unitRoots;
+		std::vector<std::optional<std::string>> m_unitErrors;
+		// every parsed entry is allocated here, and they are all
+		// freed with the parser. entries refer to each other with
+		// plain pointers. guarded by the parse mutex
+		Arena m_arena;
+		// parsed entries are shared between the threads parsing a unit.
+		// threads that wait on an entry are tracked so that reference
+		// cycles across threads do not deadlock
+		std::mutex m_parseMutex;
+		std::condition_variable m_parseCondition;
+		std::unordered_map<std::thread::id, const ParsedEntry*> m_waitingThreads;
+		// whether a cycle was broken at an entry whose name was not
+		// derived yet. guarded by the parse mutex
+		bool m_cycleNamesPending = false;
+		// the traversal the current thread is running, if any
+		static thread_local Traversal* s_traversal;
+		// names are interned parser-wide, so unit parsers use their owner's
+		StringPool m_strings;
+		// the qualified names of a unit's classes and enums by DIE offset
+		std::unordered_map<dwarf::section_offset, InternedString> m_qualifiedNames;
+		// classes and enums parsed by any unit, so units that include
+		// the same definitions share one copy instead of each parsing it
+		std::mutex m_odrMutex;
+		std::unordered_map<OdrKey, Named*, OdrKeyHasher> m_odrEntries;
+		// copies that were parsed while another unit parsed the same
+		// class or enum, and so aren't shared
+		std::vector<std::pair<OdrKey, Named*>> m_odrDuplicates;
+		// the parser a unit parser is merged into
+		Parser* m_owner = nullptr;
+		// parses every type in a type unit, for every unit, so that each
+		// signature is parsed once. it is merged after the units
+		std::unique_ptr<Parser> m_typeUnitParser;
+		// the patterns of the concepts to parse, if not everything
+		std::vector<std::regex> m_roots;
+		// the root patterns, as part of cache keys
+		std::string m_rootKey;
+		// the roots without wildcards, which can be looked up by name
+		std::vector<std::string> m_exactRoots;
+		bool m_inexactRoots = false;
+		// where units are cached, if they are
+		std::string m_unitCacheDirectory;
+		const elf::elf* m_unitCacheFile = nullptr;
+		std::optional<std::string> m_unitCacheError;
+		// the fingerprint of a unit, and whether it was loaded from the cache
+		std::string m_unitKey;
+		bool m_unitCached = false;
+		// the namespace-level DIEs of a unit to parse when there are roots
+		std::unordered_set<dwarf::section_offset> m_wantedDIEs;
+		std::atomic_bool m_failed = false;
+		// where units are printed as they finish when streaming
+		std::ostream* m_stream = nullptr;
+		// the names of printed concepts by the namespace they were printed in
+		std::unordered_map<const Namespace*,
+			std::unordered_set<InternedString, InternedString::Hasher>> m_streamedNames;
+		// handlers registered for tags. unit parsers use their owner's
+		std::unordered_map<dwarf::DW_TAG, TagHandler> m_handlers;
+		// the tasks of a unit that have not finished. the unit's own
+		// task counts until it has queued the rest
+		std::atomic_size_t m_pendingTasks = 1;
+		std::mutex m_unitMutex;
+		std::condition_variable m_unitCondition;
+		size_t m_threadCount;
+		// what was parsed. a unit's counters are guarded by the parse
+		// mutex, and are added to its owner's when it is merged
+		ParseStatistics m_statistics;
+		std::atomic_int64_t m_parseNanoseconds = 0;
+		// the file the DWARF data is loaded from, if it is known
+		const elf::elf* m_file = nullptr;
+		size_t m_infoSize = 0;
+		// the split unit of each skeleton unit, if the file has any
+		const SplitUnits* m_splitUnits = nullptr;
+		// the offset of the skeleton of each split unit being parsed
+		std::unordered_map<const dwarf::unit*, dwarf::section_offset> m_skeletonOffsets;
+		// the hash of each unit with anonymous types, which names them
+		std::mutex m_unitHashMutex;
+		std::unordered_map<const dwarf::unit*, std::string> m_unitHashes;
+		// where classes, enums and names are shared with other files
+		Parser* m_typeStore = nullptr;
+		// the resident set to stay under, if any
+		size_t m_memoryBudget = 0;
 	};
 }
 
@@ -0,0 +1,113 @@
+#ifndef DWARFTOCPP_SECTIONLOADER_H_
+#define DWARFTOCPP_SECTIONLOADER_H_
+
+/// @file
+/// DWARF Section Loader With Decompression
+/// 10/16/26 19:40
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace DWARFToCPP
+{
+	/// @brief Gives libelfin the DWARF sections of an ELF file, decompressing
+	/// SHF_COMPRESSED and .zdebug_* sections. The sections every parse needs
+	/// are decompressed up front, concurrently, into one buffer. The rest
+	/// are decompressed when libelfin first asks for them
+	class SectionLoader : public dwarf::loader
+	{
+	public:
+		/// @brief Where a unit's part of a section is in a split DWARF
+		/// package
+		struct Contribution
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		/// @param file The ELF file, which must outlive the loader. Split
+		/// DWARF sections named *.dwo are loaded as the sections they split
+		explicit SectionLoader(const elf::elf& file) noexcept;
+		/// @brief Loads one unit of a split DWARF package
+		/// @param package The package's loader, which must outlive this one
+		/// @param contributions The unit's part of each section it has a
+		/// part of. It gets the whole of every other section
+		SectionLoader(SectionLoader& package,
+			const std::map<dwarf::section_type, Contribution>& contributions) noexcept;
+
+		/// @brief Decompresses .debug_info, .debug_abbrev and .debug_str
+		/// @param threadCount The number of threads to decompress with,
+		/// 0 for one per hardware thread
+		/// @return The error, if one occurs
+		std::optional<std::string> Decompress(size_t threadCount) noexcept;
+
+		/// @param section The section
+		/// @param size_out Set to the size of the section
+		/// @return The section's data, or nullptr if the file doesn't have it
+		/// or it couldn't be decompressed
+		const void* load(dwarf::section_type section, size_t* size_out) override;
+
+		/// @param section A section
+		/// @return Whether or not the section's data is compressed, and
+		/// can only be read through a loader
+		static bool IsCompressed(const elf::section& section) noexcept;
+	private:
+		struct Section
+		{
+			// the section as it is in the file
+			const uint8_t* fileData = nullptr;
+			size_t fileSize = 0;
+			// where the compressed stream starts, if it is compressed
+			std::optional<size_t> streamOffset;
+			// the data once decompressed
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			std::optional<std::string> error;
+			// owns the data of sections decompressed on demand
+			std::unique_ptr<uint8_t[]> buffer;
+			std::once_flag decompressed;
+		};
+
+		/// @brief Reads the header of a compressed section
+		/// @param section The section
+		/// @param name The name of the section in the file
+		/// @param flagged Whether or not the section is SHF_COMPRESSED
+		/// @param is64 Whether or not the file is a 64-bit ELF file
+		static void ReadHeader(Section& section, const std::string& name,
+			bool flagged, bool is64) noexcept;
+
+		/// @brief Fails a section whose header claims more bytes than its
+		/// compressed stream can inflate to
+		/// @param section The section, with its header read
+		/// @param name The name of the section in the file
+		static void CheckSize(Section& section, const std::string& name) noexcept;
+
+		/// @brief Decompresses a section into a buffer of its size
+		/// @param section The section
+		/// @param out The buffer
+		/// @return The error, if one occurs
+		static std::optional<std::string> Inflate(const Section& section, uint8_t* out) noexcept;
+
+		// only the sections the file has
+		std::map<dwarf::section_type, std::unique_ptr<Section>> m_sections;
+		// owns the data of the sections decompressed up front
+		std::unique_ptr<uint8_t[]> m_pool;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef DWARFTOCPP_SPLITUNITS_H_
+#define DWARFTOCPP_SPLITUNITS_H_
+
+/// @file
+/// Split DWARF Units From .dwo Files and .dwp Packages
+/// 10/16/26 20:15
+
+// DWARFToCPP includes
+#include <DWARFToCPP/SectionLoader.h>
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <elf++.hh>
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Finds the split unit of every skeleton unit of a file built
+	/// with -gsplit-dwarf, in the .dwo file the skeleton names or in a
+	/// .dwp package through its unit index
+	class SplitUnits
+	{
+	public:
+		/// @brief The unit a skeleton unit stands for
+		struct Unit
+		{
+			const dwarf::compilation_unit* unit;
+			// the size of the unit in its .debug_info
+			size_t bytes;
+		};
+
+		/// @brief Opens the split unit of every skeleton unit, on every thread
+		/// @param file The ELF file with the skeleton units
+		/// @param data The DWARF data of the file
+		/// @param packagePath The path of the .dwp package, or empty to
+		/// only look for .dwo files
+		/// @param threadCount The number of threads to open files with,
+		/// 0 for one per hardware thread
+		/// @return The error, if the package can't be read. Missing .dwo
+		/// files are counted instead, and their skeletons parsed as they are
+		std::optional<std::string> Open(const elf::elf& file, const dwarf::dwarf& data,
+			const std::string& packagePath, size_t threadCount) noexcept;
+
+		/// @param skeleton A unit of the ELF file
+		/// @return The split unit the skeleton stands for, if it was found
+		const Unit* Find(const dwarf::compilation_unit& skeleton) const noexcept;
+
+		/// @return The number of skeleton units whose split unit wasn't found
+		size_t MissingCount() const noexcept { return m_missingCount; }
+	private:
+		/// @brief A skeleton unit, and where its split unit is
+		struct Skeleton
+		{
+			const dwarf::compilation_unit* unit;
+			std::string dwoPath;
+			std::optional<uint64_t> dwoId;
+		};
+
+		/// @brief A .dwo file, or one unit of a package, kept open for as
+		/// long as its unit is parsed
+		struct SplitFile
+		{
+			elf::elf file;
+			std::shared_ptr<SectionLoader> loader;
+			dwarf::dwarf data;
+		};
+
+		/// @brief Loads what libelfin loads lazily, so the unit can be
+		/// parsed from any thread
+		/// @param splitFile The file
+		/// @return Whether or not the file has a unit
+		static bool Preload(SplitFile& splitFile) noexcept;
+
+		/// @brief Finds the .dwo file and ID of a unit, if it is a skeleton
+		/// @param file The ELF file
+		/// @param unit The unit
+		/// @return The skeleton, if the unit is one
+		static std::optional<Skeleton> ReadSkeleton(const elf::elf& file,
+			const dwarf::compilation_unit& unit) noexcept;
+
+		/// @brief Opens and maps a .dwo file
+		/// @param skeleton The skeleton naming the file
+		/// @return The file, if it could be opened and has a unit
+		static std::unique_ptr<SplitFile> OpenDwo(const Skeleton& skeleton) noexcept;
+
+		/// @brief Reads a package's unit index
+		/// @param skeletons The skeletons to find the units of
+		/// @param contributions Set to the section contributions of each
+		/// skeleton's unit, if the package has it
+		/// @return The error, if one occurs
+		std::optional<std::string> ReadPackageIndex(const std::vector<Skeleton>& skeletons,
+			std::vector<std::optional<std::map<dwarf::section_type,
+			SectionLoader::Contribution>>>& contributions) const noexcept;
+
+		// the package, when there is one
+		std::optional<elf::elf> m_packageFile;
+		std::shared_ptr<SectionLoader> m_packageLoader;
+		std::vector<std::unique_ptr<SplitFile>> m_files;
+		std::unordered_map<const dwarf::compilation_unit*, Unit> m_units;
+		size_t m_missingCount = 0;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef DWARFTOCPP_STATISTICS_H_
+#define DWARFTOCPP_STATISTICS_H_
+
+/// @file
+/// Counters Collected While Parsing
+/// 10/16/26 16:40
+
+// libelfin includes
+#if _WIN32
+#pragma warning(push, 0)
+#endif
+#include <dwarf++.hh>
+#if _WIN32
+#pragma warning(pop)
+#endif
+
+// STL includes
+#include <array>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief What a parser did, and where its time went
+	struct ParseStatistics
+	{
+		struct TagCounts
+		{
+			// DIEs of the tag that were requested, including memo hits
+			size_t visited = 0;
+			// concepts created for DIEs of the tag
+			size_t created = 0;
+		};
+
+		/// @brief The counters of each tag. Standard tags are counted in
+		/// a flat array, so counting a DIE is one index, and vendor tags,
+		/// which are far apart, in a map
+		class TagTable
+		{
+		public:
+			/// @param tag A tag
+			/// @return The counters of the tag
+			TagCounts& operator[](dwarf::DW_TAG tag) noexcept
+			{
+				const auto index = static_cast<size_t>(tag);
+				return (index < m_standard.size()) ? m_standard[index] : m_vendor[tag];
+			}
+
+			/// @brief Calls a function with each tag that was counted and its
+			/// counters, in the order of the tags
+			/// @param func The function
+			template<typename Func> void ForEach(Func&& func) const noexcept
+			{
+				for (size_t index = 0; index < m_standard.size(); ++index)
+				{
+					const auto& counts = m_standard[index];
+					if (counts.visited != 0 || counts.created != 0)
+						func(static_cast<dwarf::DW_TAG>(index), counts);
+				}
+				for (const auto& [tag, counts] : m_vendor)
+					func(tag, counts);
+			}
+		private:
+			// every standard tag is below this
+			std::array<TagCounts, 0x80> m_standard{};
+			std::map<dwarf::DW_TAG, TagCounts> m_vendor;
+		};
+
+		struct UnitStatistics
+		{
+			dwarf::section_offset offset = 0;
+			// the size of the unit in .debug_info, 0 if it is unknown
+			size_t bytes = 0;
+			// the time spent parsing the unit, summed over every thread
+			double seconds = 0;
+			// the DIEs the unit parsed or loaded
+			size_t entries = 0;
+			bool cached = false;
+		};
+
+		/// @brief Adds another parser's DIE and memo counters to these
+		/// @param other The other statistics
+		void Merge(const ParseStatistics& other) noexcept;
+		/// @brief Prints the statistics as a JSON object
+		/// @param outFile The output file
+		void PrintJSON(std::ostream& outFile) const noexcept;
+
+		// indexed by tag, so the output is in tag order
+		TagTable tags;
+		// lookups of parsed entries by DIE
+		size_t memoHits = 0;
+		size_t memoMisses = 0;
+		// misses that were shared from another unit instead of parsed
+		size_t odrShared = 0;
+		// misses for types in type units, which are parsed once and shared
+		size_t typeUnitShared = 0;
+		// in the order the units were merged
+		std::vector<UnitStatistics> units;
+		// concepts added to the global namespace, namespaces that were
+		// merged into an existing one, and concepts that already existed
+		size_t conceptsAdded = 0;
+		size_t namespacesMerged = 0;
+		size_t duplicatesSkipped = 0;
+		// the time spent merging units into the global namespace
+		double mergeSeconds = 0;
+		// the most bytes reserved for concepts by the parser and its
+		// finished units at once
+		size_t peakNodeBytes = 0;
+		// the largest anonymous resident set measured between windows, with a
+		// memory budget
+		size_t peakResidentBytes = 0;
+	};
+}
+
+#endif
\ No newline at end of file
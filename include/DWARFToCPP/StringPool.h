@@ -0,0 +1,112 @@
+#ifndef DWARFTOCPP_STRINGPOOL_H_
+#define DWARFTOCPP_STRINGPOOL_H_
+
+/// @file
+/// Interned Strings
+/// 10/16/26 13:10
+
+// DWARFToCPP includes
+#include <DWARFToCPP/Arena.h>
+
+// STL includes
+#include <array>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace DWARFToCPP
+{
+	class StringPool;
+
+	/// @brief A handle to a string owned by a StringPool. Handles from the
+	/// same pool are equal exactly when their strings are equal
+	class InternedString
+	{
+	public:
+		/// @brief Hashes a handle by its string's contents, so containers
+		/// keyed by handles behave like containers keyed by strings
+		struct Hasher
+		{
+			size_t operator()(const InternedString& str) const noexcept { return str.Hash(); }
+		};
+
+		/// @brief Creates an empty string
+		InternedString() noexcept = default;
+
+		/// @return The string
+		std::string_view View() const noexcept { return (m_entry != nullptr) ? m_entry->view : std::string_view(); }
+		/// @return The hash of the string's contents
+		size_t Hash() const noexcept { return (m_entry != nullptr) ? m_entry->hash : std::hash<std::string_view>()({}); }
+		/// @return Whether or not the string is empty
+		bool Empty() const noexcept { return View().empty(); }
+
+		bool operator==(const InternedString& other) const noexcept = default;
+	private:
+		friend StringPool;
+
+		struct Entry
+		{
+			std::string_view view;
+			size_t hash;
+		};
+
+		/// @param entry The pooled entry
+		explicit InternedString(const Entry* entry) noexcept : m_entry(entry) {}
+
+		const Entry* m_entry = nullptr;
+	};
+
+	/// @brief Stores one copy of each distinct string. Safe to use
+	/// from multiple threads
+	class StringPool
+	{
+	public:
+		/// @brief Interns a string
+		/// @param str The string
+		/// @return The interned string, which lives as long as the pool
+		InternedString Intern(std::string_view str) noexcept;
+
+		/// @brief Finds a string without interning it
+		/// @param str The string
+		/// @return The interned string, if the string was interned
+		std::optional<InternedString> Find(std::string_view str) const noexcept;
+	private:
+		// strings are spread over shards by hash so threads rarely
+		// contend on the same lock
+		static constexpr size_t ShardCount = 16;
+
+		struct Key
+		{
+			std::string_view view;
+			size_t hash;
+
+			bool operator==(const Key& other) const noexcept { return view == other.view; }
+		};
+
+		struct KeyHasher
+		{
+			size_t operator()(const Key& key) const noexcept { return key.hash; }
+		};
+
+		struct Shard
+		{
+			mutable std::mutex mutex;
+			std::unordered_map<Key, const InternedString::Entry*, KeyHasher> entries;
+			// the characters and entries of every string in the shard
+			Arena arena;
+		};
+
+		/// @param hash The hash of a string
+		/// @return The shard the string belongs to
+		Shard& ShardFor(size_t hash) noexcept { return m_shards[(hash >> 7) % ShardCount]; }
+		/// @param hash The hash of a string
+		/// @return The shard the string belongs to
+		const Shard& ShardFor(size_t hash) const noexcept { return m_shards[(hash >> 7) % ShardCount]; }
+
+		std::array<Shard, ShardCount> m_shards;
+	};
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef DWARFTOCPP_TASKPOOL_H_
+#define DWARFTOCPP_TASKPOOL_H_
+
+/// @file
+/// Work-Stealing Task Pool
+/// 10/16/26 11:20
+
+// STL includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief Runs tasks on a fixed number of threads. Each thread has its
+	/// own queue, and threads that run out of work steal from the others
+	class TaskPool
+	{
+	public:
+		using Task = std::function<void()>;
+
+		/// @param threadCount The number of threads to run tasks on, including
+		/// the thread that calls Run. 0 uses one thread per hardware thread
+		explicit TaskPool(size_t threadCount) noexcept;
+
+		/// @brief Queues a task. Tasks queued from a task running in this pool
+		/// are run next by the same thread unless stolen. Others are spread
+		/// evenly across threads and run in the order they were queued
+		/// @param task The task
+		void Push(Task task) noexcept;
+
+		/// @brief Runs queued tasks on every thread until all tasks, including
+		/// those queued by other tasks, have finished
+		void Run() noexcept;
+
+		/// @return The number of threads tasks run on
+		size_t ThreadCount() const noexcept { return m_workerCount; }
+	private:
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		/// @brief Takes the most recently queued task from a worker's own queue
+		/// @param workerIndex The worker's index
+		/// @return The task, if there was one
+		std::optional<Task> Pop(size_t workerIndex) noexcept;
+		/// @brief Takes the oldest task from another worker's queue
+		/// @param thiefIndex The index of the worker that is stealing
+		/// @return The task, if there was one
+		std::optional<Task> Steal(size_t thiefIndex) noexcept;
+		/// @brief Runs tasks until there are none pending
+		/// @param workerIndex The worker's index
+		void RunWorker(size_t workerIndex) noexcept;
+		/// @brief Wakes idle workers to look for tasks again
+		/// @param all Whether to wake every worker, or just one
+		void Wake(bool all) noexcept;
+
+		size_t m_workerCount;
+		std::unique_ptr<Worker[]> m_workers;
+		// tasks that are queued or running
+		std::atomic_size_t m_pendingTasks = 0;
+		std::atomic_size_t m_nextWorker = 0;
+		// idle workers wait until a task is queued or the last one finishes
+		std::mutex m_idleMutex;
+		std::condition_variable m_idleCondition;
+		uint64_t m_wakeups = 0;
+	};
+}
+
+#endif
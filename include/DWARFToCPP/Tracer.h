@@ -0,0 +1,126 @@
+#ifndef DWARFTOCPP_TRACER_H_
+#define DWARFTOCPP_TRACER_H_
+
+/// @file
+/// Trace-Event Timeline Of Parsing And Printing
+/// 10/16/26 17:15
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace DWARFToCPP
+{
+	/// @brief A named number attached to a traced event
+	struct TraceArg
+	{
+		const char* name;
+		uint64_t value;
+	};
+
+	/// @brief Records scoped events from every thread, and writes them as
+	/// trace-event JSON for Perfetto or chrome://tracing. While a tracer
+	/// exists, every TraceScope records to it. Only one may exist at a time
+	class Tracer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/// @param threshold Scopes that ask for it are only recorded if they
+		/// take at least this long
+		explicit Tracer(std::chrono::microseconds threshold = std::chrono::milliseconds(1)) noexcept;
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+		~Tracer();
+
+		/// @return The tracer that scopes record to, or nullptr
+		static Tracer* Current() noexcept { return s_current.load(std::memory_order_relaxed); }
+
+		/// @brief Records a finished event
+		/// @param category The category of the event
+		/// @param name The name of the event
+		/// @param args The numbers attached to the event
+		/// @param start When the event started
+		/// @param end When the event ended
+		/// @param thresholded Whether or not to drop the event if it is
+		/// shorter than the threshold
+		void Record(const char* category, std::string name, std::vector<TraceArg> args,
+			Clock::time_point start, Clock::time_point end, bool thresholded) noexcept;
+
+		/// @brief Writes every recorded event
+		/// @param path The path of the trace file
+		/// @return The error, if one occurs
+		std::optional<std::string> Write(const std::string& path) const noexcept;
+	private:
+		struct Event
+		{
+			const char* category;
+			std::string name;
+			std::vector<TraceArg> args;
+			// relative to when the tracer was created
+			std::chrono::nanoseconds start;
+			std::chrono::nanoseconds duration;
+			size_t thread;
+		};
+
+		static std::atomic<Tracer*> s_current;
+
+		Clock::time_point m_start;
+		std::chrono::nanoseconds m_threshold;
+		mutable std::mutex m_mutex;
+		std::vector<Event> m_events;
+	};
+
+	/// @brief Records an event from its construction to its destruction,
+	/// if a tracer exists. Otherwise it does nothing
+	class TraceScope
+	{
+	public:
+		/// @param category The category of the event
+		/// @param name The name of the event, copied only when tracing
+		/// @param args The numbers attached to the event
+		/// @param thresholded Whether or not to drop the event if it is
+		/// shorter than the tracer's threshold
+		TraceScope(const char* category, std::string_view name,
+			std::initializer_list<TraceArg> args = {}, bool thresholded = false) noexcept :
+			m_tracer(Tracer::Current())
+		{
+			if (m_tracer == nullptr)
+				return;
+			m_category = category;
+			m_name = name;
+			m_args = args;
+			m_thresholded = thresholded;
+			m_start = Tracer::Clock::now();
+		}
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+		~TraceScope() { End(); }
+
+		/// @brief Ends the event before the scope does
+		void End() noexcept
+		{
+			if (m_tracer == nullptr)
+				return;
+			m_tracer->Record(m_category, std::move(m_name), std::move(m_args),
+				m_start, Tracer::Clock::now(), m_thresholded);
+			m_tracer = nullptr;
+		}
+	private:
+		Tracer* m_tracer;
+		const char* m_category = nullptr;
+		std::string m_name;
+		std::vector<TraceArg> m_args;
+		bool m_thresholded = false;
+		Tracer::Clock::time_point m_start;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include <DWARFToCPP/Accelerator.h>
+#include <DWARFToCPP/SectionLoader.h>
+
+#include <cctype>
+#include <cstring>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	/// @brief Reads a section, bounds-checked. Once anything is read out
+	/// of bounds, every read returns 0 and Failed reports it
+	class SectionReader
+	{
+	public:
+		/// @param data The section
+		/// @param offset Where to start reading
+		explicit SectionReader(std::string_view data, size_t offset = 0) noexcept :
+			m_data(data), m_offset(offset), m_failed(offset > data.size()) {}
+
+		/// @tparam T The type of the integer
+		/// @return A little-endian integer
+		template<typename T>
+		T Read() noexcept
+		{
+			T value = 0;
+			if (m_failed == true || sizeof(T) > m_data.size() - m_offset)
+			{
+				m_failed = true;
+				return 0;
+			}
+			std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return value;
+		}
+		/// @param size 4 or 8
+		/// @return An offset of the given size
+		uint64_t ReadOffset(size_t size) noexcept
+		{
+			return (size == 8) ? Read<uint64_t>() : Read<uint32_t>();
+		}
+		/// @return An unsigned LEB128 integer
+		uint64_t ReadULEB() noexcept
+		{
+			uint64_t value = 0;
+			for (size_t shift = 0;; shift += 7)
+			{
+				const auto byte = Read<uint8_t>();
+				if (shift < 64)
+					value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0 || m_failed == true)
+					return value;
+			}
+		}
+		/// @return A null-terminated string
+		std::string_view ReadString() noexcept
+		{
+			const auto end = (m_failed == true) ? std::string_view::npos : m_data.find('\0', m_offset);
+			if (end == std::string_view::npos)
+			{
+				m_failed = true;
+				return std::string_view();
+			}
+			const auto str = m_data.substr(m_offset, end - m_offset);
+			m_offset = end + 1;
+			return str;
+		}
+		/// @brief Skips bytes
+		/// @param count The number of bytes
+		void Skip(uint64_t count) noexcept
+		{
+			if (count > m_data.size() - m_offset)
+				m_failed = true;
+			else
+				m_offset += count;
+		}
+
+		/// @brief Reads a unit length, which is 64-bit if the 32-bit
+		/// length is all ones
+		/// @param offsetSize Set to the size of offsets in the unit
+		/// @return The offset the unit ends at
+		size_t ReadUnitLength(size_t& offsetSize) noexcept
+		{
+			uint64_t length = Read<uint32_t>();
+			offsetSize = 4;
+			if (length == 0xffffffff)
+			{
+				length = Read<uint64_t>();
+				offsetSize = 8;
+			}
+			if (m_failed == true || length > m_data.size() - m_offset)
+			{
+				m_failed = true;
+				return m_data.size();
+			}
+			return m_offset + length;
+		}
+
+		size_t Offset() const noexcept { return m_offset; }
+		bool Failed() const noexcept { return m_failed; }
+	private:
+		std::string_view m_data;
+		size_t m_offset;
+		bool m_failed;
+	};
+
+	/// @param file The ELF file
+	/// @param name The name of a section
+	/// @return The contents of the section, or nothing if it is missing.
+	/// Compressed tables aren't worth decompressing to skip units
+	std::string_view GetSection(const elf::elf& file, const char* name) noexcept
+	{
+		const auto& section = file.get_section(name);
+		if (section.valid() == false || section.get_hdr().type == elf::sht::nobits ||
+			SectionLoader::IsCompressed(section) == true)
+			return std::string_view();
+		return std::string_view(static_cast<const char*>(section.data()), section.size());
+	}
+}
+
+AcceleratorIndex::AcceleratorIndex(const elf::elf& file) noexcept :
+	m_debugNames(GetSection(file, ".debug_names")),
+	m_gdbIndex(GetSection(file, ".gdb_index")),
+	m_pubNames(GetSection(file, ".debug_pubnames")),
+	m_pubTypes(GetSection(file, ".debug_pubtypes")),
+	m_strings(GetSection(file, ".debug_str")) {}
+
+bool AcceleratorIndex::Valid() const noexcept
+{
+	return m_debugNames.empty() == false || m_gdbIndex.empty() == false ||
+		m_pubNames.empty() == false || m_pubTypes.empty() == false;
+}
+
+bool AcceleratorIndex::Find(std::string_view name, std::vector<Location>& locations) const noexcept
+{
+	// prefer the table with the most information
+	if (m_debugNames.empty() == false)
+		return FindDebugNames(name, locations);
+	if (m_gdbIndex.empty() == false)
+		return FindGdbIndex(name, locations);
+	if (m_pubNames.empty() == true && m_pubTypes.empty() == true)
+		return false;
+	return FindPubNames(m_pubNames, name, locations) == true &&
+		FindPubNames(m_pubTypes, name, locations) == true;
+}
+
+bool AcceleratorIndex::FindDebugNames(std::string_view name, std::vector<Location>& locations) const noexcept
+{
+	// DJB hash of the case-folded name
+	uint32_t hash = 5381;
+	for (const auto c : name)
+		hash = hash * 33 + static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c)));
+	// unlinked objects each have their own name index, which
+	// linkers that don't merge them simply concatenate
+	SectionReader reader(m_debugNames);
+	while (reader.Offset() < m_debugNames.size())
+	{
+		size_t offsetSize;
+		const auto end = reader.ReadUnitLength(offsetSize);
+		if (reader.Read<uint16_t>() != 5)
+			return false;
+		reader.Skip(2);
+		const auto unitCount = reader.Read<uint32_t>();
+		const auto localTypeUnitCount = reader.Read<uint32_t>();
+		const auto foreignTypeUnitCount = reader.Read<uint32_t>();
+		const auto bucketCount = reader.Read<uint32_t>();
+		const auto nameCount = reader.Read<uint32_t>();
+		const auto abbrevSize = reader.Read<uint32_t>();
+		reader.Skip(reader.Read<uint32_t>());
+		const auto unitsOffset = reader.Offset();
+		reader.Skip((uint64_t(unitCount) + localTypeUnitCount) * offsetSize +
+			uint64_t(foreignTypeUnitCount) * 8);
+		const auto bucketsOffset = reader.Offset();
+		reader.Skip(uint64_t(bucketCount) * 4);
+		const auto hashesOffset = reader.Offset();
+		reader.Skip((bucketCount != 0) ? uint64_t(nameCount) * 4 : 0);
+		const auto stringOffsetsOffset = reader.Offset();
+		reader.Skip(uint64_t(nameCount) * offsetSize);
+		const auto entryOffsetsOffset = reader.Offset();
+		reader.Skip(uint64_t(nameCount) * offsetSize);
+		const auto abbrevsOffset = reader.Offset();
+		reader.Skip(abbrevSize);
+		const auto entryPoolOffset = reader.Offset();
+		if (reader.Failed() == true || entryPoolOffset > end)
+			return false;
+		const auto table = m_debugNames.substr(0, end);
+		// the names to compare, as 1-based indices
+		uint32_t first = 1, last = nameCount;
+		if (bucketCount != 0)
+		{
+			SectionReader bucketReader(table, bucketsOffset + size_t(hash % bucketCount) * 4);
+			first = bucketReader.Read<uint32_t>();
+			last = (first == 0) ? 0 : nameCount;
+		}
+		for (uint32_t nameIndex = first; nameIndex != 0 && nameIndex <= last; ++nameIndex)
+		{
+			if (bucketCount != 0)
+			{
+				// the names of a bucket are next to each other
+				SectionReader hashReader(table, hashesOffset + size_t(nameIndex - 1) * 4);
+				const auto nameHash = hashReader.Read<uint32_t>();
+				if (nameHash % bucketCount != hash % bucketCount)
+					break;
+				if (nameHash != hash)
+					continue;
+			}
+			SectionReader stringOffsetReader(table, stringOffsetsOffset + size_t(nameIndex - 1) * offsetSize);
+			SectionReader stringReader(m_strings, stringOffsetReader.ReadOffset(offsetSize));
+			if (stringReader.ReadString() != name)
+				continue;
+			SectionReader entryOffsetReader(table, entryOffsetsOffset + size_t(nameIndex - 1) * offsetSize);
+			SectionReader entryReader(table, entryPoolOffset + entryOffsetReader.ReadOffset(offsetSize));
+			// each entry is an abbreviation code and its attributes,
+			// and the series ends with a zero code
+			for (auto code = entryReader.ReadULEB(); code != 0 && entryReader.Failed() == false;
+				code = entryReader.ReadULEB())
+			{
+				// find the abbreviation, which is a code, a tag, and
+				// index-form pairs ending in zeros
+				SectionReader abbrevReader(table.substr(0, entryPoolOffset), abbrevsOffset);
+				while (abbrevReader.Failed() == false && abbrevReader.ReadULEB() != code)
+				{
+					abbrevReader.ReadULEB();
+					while (abbrevReader.Failed() == false)
+					{
+						const auto index = abbrevReader.ReadULEB();
+						const auto form = abbrevReader.ReadULEB();
+						// DW_FORM_implicit_const stores its value in the table
+						if (form == 0x21)
+							abbrevReader.ReadULEB();
+						if (index == 0 && form == 0)
+							break;
+					}
+				}
+				abbrevReader.ReadULEB();
+				std::optional<uint64_t> unitIndex, dieOffset;
+				bool typeUnit = false;
+				while (abbrevReader.Failed() == false)
+				{
+					const auto index = abbrevReader.ReadULEB();
+					const auto form = abbrevReader.ReadULEB();
+					if (index == 0 && form == 0)
+						break;
+					uint64_t value = 0;
+					switch (form)
+					{
+					case 0x0b: case 0x0c: case 0x11: value = entryReader.Read<uint8_t>(); break;
+					case 0x05: case 0x12: value = entryReader.Read<uint16_t>(); break;
+					case 0x06: case 0x13: value = entryReader.Read<uint32_t>(); break;
+					case 0x07: case 0x14: value = entryReader.Read<uint64_t>(); break;
+					case 0x0f: case 0x15: value = entryReader.ReadULEB(); break;
+					case 0x19: value = 1; break;
+					case 0x21: value = abbrevReader.ReadULEB(); break;
+					default: return false;
+					}
+					// DW_IDX_compile_unit, DW_IDX_type_unit and DW_IDX_die_offset
+					if (index == 1)
+						unitIndex = value;
+					else if (index == 2)
+						typeUnit = true;
+					else if (index == 3)
+						dieOffset = value;
+				}
+				if (abbrevReader.Failed() == true)
+					return false;
+				// a single unit doesn't need to be named
+				if (unitIndex.has_value() == false && unitCount == 1)
+					unitIndex = 0;
+				if (typeUnit == true || unitIndex.has_value() == false || unitIndex.value() >= unitCount)
+					continue;
+				SectionReader unitReader(table, unitsOffset + size_t(unitIndex.value()) * offsetSize);
+				const auto unitOffset = unitReader.ReadOffset(offsetSize);
+				locations.push_back(Location{ unitOffset, (dieOffset.has_value() == true) ?
+					std::optional<dwarf::section_offset>(unitOffset + dieOffset.value()) : std::nullopt });
+			}
+			if (entryReader.Failed() == true)
+				return false;
+		}
+		if (reader.Failed() == true)
+			return false;
+		reader = SectionReader(m_debugNames, end);
+	}
+	return reader.Failed() == false;
+}
+
+bool AcceleratorIndex::FindGdbIndex(std::string_view name, std::vector<Location>& locations) const noexcept
+{
+	SectionReader reader(m_gdbIndex);
+	const auto version = reader.Read<uint32_t>();
+	// older versions hash differently
+	if (version < 7)
+		return false;
+	const auto unitsOffset = reader.Read<uint32_t>();
+	const auto typeUnitsOffset = reader.Read<uint32_t>();
+	reader.Skip(4);
+	const auto symbolsOffset = reader.Read<uint32_t>();
+	const auto constantsOffset = reader.Read<uint32_t>();
+	if (reader.Failed() == true || unitsOffset > typeUnitsOffset ||
+		symbolsOffset > constantsOffset || constantsOffset > m_gdbIndex.size())
+		return false;
+	const uint32_t unitCount = (typeUnitsOffset - unitsOffset) / 16;
+	const uint32_t slotCount = (constantsOffset - symbolsOffset) / 8;
+	if (slotCount == 0)
+		return true;
+	// the hash gdb uses, on the case-folded name
+	uint32_t hash = 0;
+	for (const auto c : name)
+		hash = hash * 67 + static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c))) - 113;
+	const uint32_t mask = slotCount - 1;
+	const uint32_t step = ((hash * 17) & mask) | 1;
+	const auto constants = m_gdbIndex.substr(constantsOffset);
+	for (uint32_t slot = hash & mask, probes = 0; probes < slotCount; slot = (slot + step) & mask, ++probes)
+	{
+		SectionReader slotReader(m_gdbIndex, symbolsOffset + size_t(slot) * 8);
+		const auto nameOffset = slotReader.Read<uint32_t>();
+		const auto vectorOffset = slotReader.Read<uint32_t>();
+		if (slotReader.Failed() == true)
+			return false;
+		if (nameOffset == 0 && vectorOffset == 0)
+			break;
+		SectionReader nameReader(constants, nameOffset);
+		if (nameReader.ReadString() != name)
+			continue;
+		// the units are a count and a list of unit indices, whose
+		// high bits describe the symbol
+		SectionReader vectorReader(constants, vectorOffset);
+		const auto count = vectorReader.Read<uint32_t>();
+		for (uint32_t i = 0; i < count && vectorReader.Failed() == false; ++i)
+		{
+			const auto unitIndex = vectorReader.Read<uint32_t>() & 0xffffff;
+			if (unitIndex >= unitCount)
+				continue;
+			SectionReader unitReader(m_gdbIndex, unitsOffset + size_t(unitIndex) * 16);
+			locations.push_back(Location{ unitReader.Read<uint64_t>(), std::nullopt });
+		}
+		return vectorReader.Failed() == false;
+	}
+	return true;
+}
+
+bool AcceleratorIndex::FindPubNames(std::string_view section, std::string_view name,
+	std::vector<Location>& locations) noexcept
+{
+	// each set is a header and offset-name pairs, ending in a zero offset
+	SectionReader reader(section);
+	while (reader.Offset() < section.size() && reader.Failed() == false)
+	{
+		size_t offsetSize;
+		const auto end = reader.ReadUnitLength(offsetSize);
+		reader.Read<uint16_t>();
+		const auto unitOffset = reader.ReadOffset(offsetSize);
+		reader.ReadOffset(offsetSize);
+		for (auto dieOffset = reader.ReadOffset(offsetSize); dieOffset != 0 && reader.Failed() == false;
+			dieOffset = reader.ReadOffset(offsetSize))
+		{
+			if (reader.ReadString() == name)
+				locations.push_back(Location{ unitOffset, unitOffset + dieOffset });
+		}
+		if (reader.Failed() == true)
+			return false;
+		reader = SectionReader(section, end);
+	}
+	return reader.Failed() == false;
+}
\ No newline at end of file
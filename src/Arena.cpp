@@ -0,0 +1,78 @@
+#include <DWARFToCPP/Arena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+
+using namespace DWARFToCPP;
+
+Arena::Arena(Arena&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+	Release();
+	m_blocks = std::move(other.m_blocks);
+	m_destructors = std::move(other.m_destructors);
+	m_cursor = std::exchange(other.m_cursor, nullptr);
+	m_end = std::exchange(other.m_end, nullptr);
+	m_bytesReserved = std::exchange(other.m_bytesReserved, 0);
+	other.m_blocks.clear();
+	other.m_destructors.clear();
+	return *this;
+}
+
+Arena::~Arena()
+{
+	Release();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) noexcept
+{
+	auto address = reinterpret_cast<uintptr_t>(m_cursor);
+	auto aligned = (address + alignment - 1) & ~(alignment - 1);
+	if (m_cursor == nullptr ||
+		aligned + size > reinterpret_cast<uintptr_t>(m_end))
+	{
+		// oversized allocations get a block of their own
+		const size_t blockSize = std::max(BlockSize, size + alignment);
+		m_cursor = m_blocks.emplace_back(new std::byte[blockSize]).get();
+		m_end = m_cursor + blockSize;
+		m_bytesReserved += blockSize;
+		address = reinterpret_cast<uintptr_t>(m_cursor);
+		aligned = (address + alignment - 1) & ~(alignment - 1);
+	}
+	m_cursor += (aligned - address) + size;
+	return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::Adopt(Arena&& other) noexcept
+{
+	// keep allocating from our current block. the other arena's
+	// partially filled block is simply retired
+	m_blocks.insert(m_blocks.end(), std::make_move_iterator(other.m_blocks.begin()),
+		std::make_move_iterator(other.m_blocks.end()));
+	m_destructors.insert(m_destructors.end(), other.m_destructors.begin(),
+		other.m_destructors.end());
+	m_bytesReserved += std::exchange(other.m_bytesReserved, 0);
+	other.m_blocks.clear();
+	other.m_destructors.clear();
+	other.m_cursor = nullptr;
+	other.m_end = nullptr;
+}
+
+void Arena::Release() noexcept
+{
+	// objects may refer to each other, but not in their destructors
+	for (const auto& destructor : m_destructors | std::views::reverse)
+		destructor.destroy(destructor.object);
+	m_destructors.clear();
+	m_blocks.clear();
+	m_cursor = nullptr;
+	m_end = nullptr;
+	m_bytesReserved = 0;
+}
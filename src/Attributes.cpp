@@ -0,0 +1,83 @@
+#include <DWARFToCPP/Attributes.h>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	// standard attributes are all below this, vendor ones are read through the DIE
+	constexpr size_t SlotTableSize = 0x80;
+}
+
+Attributes::Attributes(const dwarf::die& die) noexcept :
+	m_die(die)
+{
+	static_assert(Decoded.size() <= 32, "Too many decoded attributes for the loaded bits");
+}
+
+bool Attributes::Has(dwarf::DW_AT attribute) const noexcept
+{
+	const auto slot = GetSlot(attribute);
+	if (slot == NoSlot)
+		return m_die.has(attribute);
+	return Load(attribute, slot).valid();
+}
+
+dwarf::value Attributes::Get(dwarf::DW_AT attribute) const noexcept
+{
+	const auto slot = GetSlot(attribute);
+	if (slot == NoSlot)
+		return (m_die.has(attribute) == true) ? m_die[attribute] : dwarf::value();
+	return Load(attribute, slot);
+}
+
+dwarf::value Attributes::Resolve(dwarf::DW_AT attribute) const noexcept
+{
+	if (Has(attribute) == true)
+		return Get(attribute);
+	// the same order as die::resolve: a specification of the abstract
+	// origin is followed, but not an origin of the specification
+	const auto find = [attribute](const dwarf::die& die)
+	{
+		return (die.has(attribute) == true) ? die[attribute] : dwarf::value();
+	};
+	if (Has(dwarf::DW_AT::abstract_origin) == true)
+	{
+		const auto origin = Get(dwarf::DW_AT::abstract_origin).as_reference();
+		if (origin.has(attribute) == true)
+			return origin[attribute];
+		if (origin.has(dwarf::DW_AT::specification) == true)
+			return find(origin[dwarf::DW_AT::specification].as_reference());
+	}
+	else if (Has(dwarf::DW_AT::specification) == true)
+		return find(Get(dwarf::DW_AT::specification).as_reference());
+	return dwarf::value();
+}
+
+const dwarf::value& Attributes::Load(dwarf::DW_AT attribute, uint8_t slot) const noexcept
+{
+	// die::attributes would build a vector for every DIE, so each
+	// attribute is looked up in the abbreviation the first time instead
+	const auto bit = uint32_t(1) << slot;
+	if ((m_loaded & bit) == 0)
+	{
+		if (m_die.has(attribute) == true)
+			m_values[slot] = m_die[attribute];
+		m_loaded |= bit;
+	}
+	return m_values[slot];
+}
+
+uint8_t Attributes::GetSlot(dwarf::DW_AT attribute) noexcept
+{
+	// built once, so finding a slot is one load
+	static constexpr auto slots = []()
+	{
+		std::array<uint8_t, SlotTableSize> table{};
+		table.fill(NoSlot);
+		for (size_t slot = 0; slot < Decoded.size(); ++slot)
+			table[static_cast<size_t>(Decoded[slot])] = static_cast<uint8_t>(slot);
+		return table;
+	}();
+	const auto index = static_cast<size_t>(attribute);
+	return (index < slots.size()) ? slots[index] : NoSlot;
+}
\ No newline at end of file
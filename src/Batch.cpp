@@ -0,0 +1,330 @@
+#include <DWARFToCPP/Batch.h>
+#include <DWARFToCPP/BufferedWriter.h>
+#include <DWARFToCPP/TaskPool.h>
+#include <DWARFToCPP/Tracer.h>
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#pragma warning(disable : 4996)
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace DWARFToCPP;
+
+Batch::Batch(size_t threadCount) noexcept :
+	m_threadCount(threadCount != 0 ? threadCount :
+		std::max<size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+std::optional<std::string> Batch::Parse(const std::vector<std::string>& paths) noexcept
+{
+	// parse as many files at once as there are threads, and split the
+	// threads between them. a file that finishes early leaves its
+	// threads idle, but files are usually many and alike
+	const size_t fileThreads = std::min(m_threadCount, std::max<size_t>(paths.size(), 1));
+	const size_t threadsPerFile = std::max<size_t>(m_threadCount / fileThreads, 1);
+	const size_t firstInput = m_inputs.size();
+	for (const auto& path : paths)
+	{
+		m_inputs.emplace_back(new Input());
+		m_inputs.back()->path = path;
+	}
+	std::vector<std::optional<std::string>> errors(paths.size());
+	TaskPool pool(fileThreads);
+	for (size_t inputIndex = 0; inputIndex < paths.size(); ++inputIndex)
+	{
+		pool.Push([this, &errors, inputIndex, firstInput, threadsPerFile]()
+			{
+				auto& input = *m_inputs[firstInput + inputIndex];
+				TraceScope fileScope("load", input.path);
+				errors[inputIndex] = ParseInput(input, threadsPerFile);
+			});
+	}
+	pool.Run();
+	for (auto& error : errors)
+	{
+		if (error.has_value() == true)
+			return std::move(error);
+	}
+	return std::nullopt;
+}
+
+std::optional<std::string> Batch::ParseInput(Input& input, size_t threadCount) noexcept
+{
+	int fd = open(input.path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return "Failed to open file " + input.path;
+	try
+	{
+		input.file = elf::elf(elf::create_mmap_loader(fd));
+		input.loader = std::make_shared<SectionLoader>(input.file);
+		if (auto error = input.loader->Decompress(threadCount); error.has_value() == true)
+			return "Failed to decompress " + input.path + ": " + error.value();
+		input.data = dwarf::dwarf(input.loader);
+		// a package next to the file is used like it is for one file
+		std::string packagePath = input.path + ".dwp";
+		std::error_code error;
+		if (std::filesystem::exists(packagePath, error) == false)
+			packagePath.clear();
+		if (auto err = input.splitUnits.Open(input.file, input.data, packagePath, threadCount);
+			err.has_value() == true)
+			return err;
+	}
+	catch (const std::exception& e)
+	{
+		return "Failed to load " + input.path + ": " + e.what();
+	}
+	input.parser = std::make_unique<Parser>(threadCount);
+	auto& parser = *input.parser;
+	parser.ShareTypes(m_store);
+	for (const auto& [pattern, regex] : m_roots)
+	{
+		if (auto error = parser.AddRoot(pattern, regex); error.has_value() == true)
+			return error;
+	}
+	parser.SetFile(input.file);
+	parser.SetSplitUnits(input.splitUnits);
+	if (auto error = parser.ParseDWARF(input.data); error.has_value() == true)
+		return "Failed to parse " + input.path + ": " + error.value();
+	return std::nullopt;
+}
+
+std::optional<std::string> Batch::PrintToDirectory(const std::string& directory) const noexcept
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error)
+		return "Failed to create output directory " + directory + ": " + error.message();
+	// files that parsed the same class or enum at the same time each
+	// have a copy, so shared concepts are found by their ODR key. each
+	// key stands for the first copy of it, and everything else for itself
+	std::unordered_map<const Named*, const Parser::OdrKey*> odrKeys;
+	for (const auto& [key, named] : m_store.m_odrEntries)
+		odrKeys.emplace(named, &key);
+	for (const auto& [key, named] : m_store.m_odrDuplicates)
+		odrKeys.emplace(named, &key);
+	std::unordered_map<Parser::OdrKey, const Named*, Parser::OdrKeyHasher> keyConcepts;
+	const auto identify = [&](const Named* named)
+	{
+		const auto keyIt = odrKeys.find(named);
+		if (keyIt == odrKeys.end())
+			return named;
+		return keyConcepts.try_emplace(*keyIt->second, named).first->second;
+	};
+	using Concepts = std::vector<std::pair<std::vector<std::string_view>, Named*>>;
+	std::vector<Concepts> inputConcepts(m_inputs.size());
+	// the number of files each concept is in, and the last file it was
+	// counted for, since a file may have more than one copy
+	std::unordered_map<const Named*, std::pair<size_t, size_t>> fileCounts;
+	for (size_t inputIndex = 0; inputIndex < m_inputs.size(); ++inputIndex)
+	{
+		std::vector<std::string_view> namespaces;
+		CollectConcepts(m_inputs[inputIndex]->parser->m_globalNamespace,
+			namespaces, inputConcepts[inputIndex]);
+		for (const auto& [conceptNamespaces, named] : inputConcepts[inputIndex])
+		{
+			auto& [fileCount, lastInput] = fileCounts.try_emplace(identify(named), 0, inputIndex).first->second;
+			if (fileCount == 0 || lastInput != inputIndex)
+				++fileCount;
+			lastInput = inputIndex;
+		}
+	}
+	// a class in common.h needs what it holds by value and inherits to
+	// be complete there too, so classes that need a concept that isn't
+	// shared go back to the headers of their files, until none do
+	std::unordered_map<const Named*, std::vector<const Named*>> dependencies;
+	for (const auto& concepts : inputConcepts)
+	{
+		for (const auto& [namespaces, named] : concepts)
+		{
+			const auto identity = identify(named);
+			if (fileCounts[identity].first < 2 || named->GetType() != Named::Type::Typed ||
+				static_cast<const Typed*>(named)->GetTypeCode() != Typed::TypeCode::Class)
+				continue;
+			auto [dependencyIt, added] = dependencies.try_emplace(identity);
+			if (added == false)
+				continue;
+			std::vector<const Named*> classDependencies;
+			CollectDependencies(*static_cast<const Class*>(named), classDependencies);
+			for (const auto dependency : classDependencies)
+			{
+				const auto dependencyIdentity = identify(dependency);
+				// what isn't printed on its own is printed wherever it's used
+				if (dependencyIdentity != identity && fileCounts.count(dependencyIdentity) != 0)
+					dependencyIt->second.push_back(dependencyIdentity);
+			}
+		}
+	}
+	std::unordered_set<const Named*> common;
+	for (const auto& [identity, counts] : fileCounts)
+	{
+		if (counts.first >= 2)
+			common.insert(identity);
+	}
+	for (bool removed = true; removed == true;)
+	{
+		removed = false;
+		for (const auto& [identity, classDependencies] : dependencies)
+		{
+			if (common.count(identity) == 0)
+				continue;
+			for (const auto dependency : classDependencies)
+			{
+				if (common.count(dependency) == 0)
+				{
+					common.erase(identity);
+					removed = true;
+					break;
+				}
+			}
+		}
+	}
+	// concepts are grouped by namespace, so each namespace is opened
+	// once per header
+	using Groups = std::map<std::vector<std::string_view>, std::vector<Named*>>;
+	Groups commonGroups;
+	std::vector<Groups> inputGroups(m_inputs.size());
+	std::unordered_set<const Named*> printedCommon;
+	for (size_t inputIndex = 0; inputIndex < m_inputs.size(); ++inputIndex)
+	{
+		for (const auto& [namespaces, named] : inputConcepts[inputIndex])
+		{
+			const auto identity = identify(named);
+			if (common.count(identity) == 0)
+				inputGroups[inputIndex][namespaces].push_back(named);
+			else if (printedCommon.insert(identity).second == true)
+				commonGroups[namespaces].push_back(named);
+		}
+	}
+	// each file's header is named after it
+	std::vector<std::string> headerPaths;
+	std::unordered_set<std::string> usedPaths{ "common.h" };
+	for (const auto& input : m_inputs)
+	{
+		std::string stem;
+		for (const auto c : std::filesystem::path(input->path).filename().string())
+			stem += (std::isalnum(static_cast<unsigned char>(c)) != 0) ? c : '_';
+		std::string path = stem + ".h";
+		for (size_t suffix = 1; usedPaths.insert(path).second == false; ++suffix)
+			path = stem + '_' + std::to_string(suffix) + ".h";
+		headerPaths.push_back(std::move(path));
+	}
+	const auto printGroups = [&directory](const std::string& path, const Groups& groups,
+		bool includeCommon)
+	{
+		TraceScope headerScope("print", path);
+		BufferedWriter outBuffer((std::filesystem::path(directory) / path).string(), 1 << 20);
+		std::ostream outFile(&outBuffer);
+		outFile << "#pragma once\n\n";
+		if (includeCommon == true)
+			outFile << "#include \"common.h\"\n\n";
+		for (const auto& [namespaces, concepts] : groups)
+			Parser::PrintHeader(outFile, Parser::OutputHeader{ std::string(), namespaces, concepts, {} });
+		outFile.flush();
+		return outBuffer.Close();
+	};
+	std::vector<char> printed(m_inputs.size() + 1, false);
+	TaskPool pool(m_threadCount);
+	pool.Push([&]() { printed[0] = printGroups("common.h", commonGroups, false); });
+	for (size_t inputIndex = 0; inputIndex < m_inputs.size(); ++inputIndex)
+	{
+		pool.Push([&, inputIndex]()
+			{
+				printed[inputIndex + 1] = printGroups(headerPaths[inputIndex],
+					inputGroups[inputIndex], true);
+			});
+	}
+	pool.Run();
+	if (printed[0] == false)
+		return "Failed to write header common.h";
+	for (size_t inputIndex = 0; inputIndex < m_inputs.size(); ++inputIndex)
+	{
+		if (printed[inputIndex + 1] == false)
+			return "Failed to write header " + headerPaths[inputIndex];
+	}
+	return std::nullopt;
+}
+
+ParseStatistics Batch::Statistics() const noexcept
+{
+	ParseStatistics statistics;
+	for (const auto& input : m_inputs)
+	{
+		if (input->parser != nullptr)
+			statistics.Merge(input->parser->Statistics());
+	}
+	return statistics;
+}
+
+void Batch::CollectDependencies(const Class& classConcept,
+	std::vector<const Named*>& dependencies) noexcept
+{
+	for (const auto& [parentClass, accessibility] : classConcept.GetParentClasses())
+		dependencies.push_back(parentClass);
+	for (const auto& [member, accessibility] : classConcept.GetMembers())
+	{
+		const Named* type = nullptr;
+		if (member->GetType() == Named::Type::Value)
+			type = static_cast<const Value*>(member)->GetValueType();
+		else if (member->GetType() == Named::Type::Typed)
+		{
+			// nested classes are printed inside the class
+			const auto typed = static_cast<const Typed*>(member);
+			if (typed->GetTypeCode() == Typed::TypeCode::Class)
+				CollectDependencies(*static_cast<const Class*>(typed), dependencies);
+			continue;
+		}
+		// only a pointer or reference can be to an incomplete type
+		while (type != nullptr && type->GetType() == Named::Type::Typed)
+		{
+			dependencies.push_back(type);
+			const auto typed = static_cast<const Typed*>(type);
+			switch (typed->GetTypeCode())
+			{
+			case Typed::TypeCode::Array:
+				type = static_cast<const Array*>(typed)->Type();
+				break;
+			case Typed::TypeCode::ConstType:
+				type = static_cast<const ConstType*>(typed)->Type();
+				break;
+			case Typed::TypeCode::TypeDef:
+				type = static_cast<const TypeDef*>(typed)->Type();
+				break;
+			case Typed::TypeCode::VolatileType:
+				type = static_cast<const VolatileType*>(typed)->Type();
+				break;
+			default:
+				type = nullptr;
+				break;
+			}
+		}
+	}
+}
+
+void Batch::CollectConcepts(const Namespace& scope, std::vector<std::string_view>& namespaces,
+	std::vector<std::pair<std::vector<std::string_view>, Named*>>& concepts) noexcept
+{
+	for (const auto& [name, named] : scope.GetSortedConcepts())
+	{
+		if (Namespace::IsPrinted(*named) == false)
+			continue;
+		// namespaces are merged per file, so only what is in them is shared
+		if (named->GetType() == Named::Type::Namespace)
+		{
+			namespaces.push_back(name.View());
+			CollectConcepts(*static_cast<const Namespace*>(named), namespaces, concepts);
+			namespaces.pop_back();
+			continue;
+		}
+		concepts.emplace_back(namespaces, named);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <DWARFToCPP/BufferedWriter.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+using namespace DWARFToCPP;
+
+BufferedWriter::BufferedWriter(const std::string& path, size_t bufferSize) noexcept
+{
+	// pipes and devices are written to directly
+	std::error_code error;
+	const auto status = std::filesystem::status(path, error);
+	if (std::filesystem::exists(status) == false || std::filesystem::is_regular_file(status) == true)
+	{
+		m_path = path;
+		m_tempPath = path + ".tmp";
+	}
+	m_file = std::fopen((m_tempPath.empty() == true) ? path.c_str() : m_tempPath.c_str(), "wb");
+	if (m_file == nullptr)
+	{
+		m_failed = true;
+		return;
+	}
+	// the file is already buffered here
+	std::setvbuf(m_file, nullptr, _IONBF, 0);
+	for (auto& buffer : m_buffers)
+		buffer.resize(bufferSize);
+	setp(m_buffers[0].data(), m_buffers[0].data() + bufferSize);
+	try
+	{
+		m_writeThread = std::thread(&BufferedWriter::WriteLoop, this);
+	}
+	catch (const std::system_error&)
+	{
+		// without a thread, buffers are written when they fill up
+	}
+}
+
+BufferedWriter::~BufferedWriter()
+{
+	Close();
+}
+
+bool BufferedWriter::Good() const noexcept
+{
+	std::scoped_lock lock(m_mutex);
+	return m_failed == false;
+}
+
+bool BufferedWriter::Close() noexcept
+{
+	if (m_file == nullptr)
+		return Good();
+	Swap();
+	if (m_writeThread.joinable() == true)
+	{
+		{
+			std::unique_lock lock(m_mutex);
+			WaitForWrite(lock);
+			m_closing = true;
+		}
+		m_condition.notify_all();
+		m_writeThread.join();
+	}
+	if (std::fclose(m_file) != 0)
+		m_failed = true;
+	m_file = nullptr;
+	setp(nullptr, nullptr);
+	if (m_tempPath.empty() == false)
+	{
+		std::error_code error;
+		m_unchanged = (m_failed == false && SameContents(m_tempPath, m_path) == true);
+		if (m_failed == true || m_unchanged == true)
+			std::filesystem::remove(m_tempPath, error);
+		else
+		{
+			std::filesystem::rename(m_tempPath, m_path, error);
+			if (error)
+				m_failed = true;
+		}
+		m_tempPath.clear();
+	}
+	return Good();
+}
+
+BufferedWriter::int_type BufferedWriter::overflow(int_type ch)
+{
+	if (m_file == nullptr)
+		return traits_type::eof();
+	Swap();
+	if (traits_type::eq_int_type(ch, traits_type::eof()) == false)
+	{
+		*pptr() = traits_type::to_char_type(ch);
+		pbump(1);
+	}
+	return traits_type::not_eof(ch);
+}
+
+std::streamsize BufferedWriter::xsputn(const char* str, std::streamsize count)
+{
+	if (m_file == nullptr)
+		return 0;
+	// large writes are split across buffers
+	std::streamsize written = 0;
+	while (written < count)
+	{
+		if (pptr() == epptr())
+			Swap();
+		const auto chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+		std::memcpy(pptr(), str + written, chunk);
+		pbump(static_cast<int>(chunk));
+		written += chunk;
+	}
+	return count;
+}
+
+int BufferedWriter::sync()
+{
+	if (m_file == nullptr)
+		return -1;
+	Swap();
+	std::unique_lock lock(m_mutex);
+	WaitForWrite(lock);
+	return (m_failed == true) ? -1 : 0;
+}
+
+void BufferedWriter::Swap() noexcept
+{
+	const size_t size = pptr() - pbase();
+	if (size == 0)
+		return;
+	auto& buffer = m_buffers[m_activeBuffer];
+	if (m_writeThread.joinable() == false)
+	{
+		if (std::fwrite(buffer.data(), 1, size, m_file) != size)
+			m_failed = true;
+		setp(buffer.data(), buffer.data() + buffer.size());
+		return;
+	}
+	{
+		std::unique_lock lock(m_mutex);
+		WaitForWrite(lock);
+		m_pendingData = buffer.data();
+		m_pendingSize = size;
+	}
+	m_condition.notify_all();
+	m_activeBuffer ^= 1;
+	auto& nextBuffer = m_buffers[m_activeBuffer];
+	setp(nextBuffer.data(), nextBuffer.data() + nextBuffer.size());
+}
+
+bool BufferedWriter::SameContents(const std::string& lhsPath, const std::string& rhsPath) noexcept
+{
+	std::error_code error;
+	const auto size = std::filesystem::file_size(lhsPath, error);
+	if (error || std::filesystem::file_size(rhsPath, error) != size || error)
+		return false;
+	std::FILE* lhs = std::fopen(lhsPath.c_str(), "rb");
+	std::FILE* rhs = std::fopen(rhsPath.c_str(), "rb");
+	bool same = (lhs != nullptr && rhs != nullptr);
+	std::vector<char> lhsChunk(1 << 16);
+	std::vector<char> rhsChunk(lhsChunk.size());
+	while (same == true)
+	{
+		const size_t read = std::fread(lhsChunk.data(), 1, lhsChunk.size(), lhs);
+		same = (std::fread(rhsChunk.data(), 1, rhsChunk.size(), rhs) == read &&
+			std::memcmp(lhsChunk.data(), rhsChunk.data(), read) == 0);
+		if (read < lhsChunk.size())
+			break;
+	}
+	if (lhs != nullptr)
+		std::fclose(lhs);
+	if (rhs != nullptr)
+		std::fclose(rhs);
+	return same;
+}
+
+void BufferedWriter::WaitForWrite(std::unique_lock<std::mutex>& lock) noexcept
+{
+	m_condition.wait(lock, [this]() { return m_pendingData == nullptr; });
+}
+
+void BufferedWriter::WriteLoop() noexcept
+{
+	std::unique_lock lock(m_mutex);
+	while (true)
+	{
+		m_condition.wait(lock, [this]() { return m_pendingData != nullptr || m_closing == true; });
+		if (m_pendingData == nullptr)
+			return;
+		const auto data = m_pendingData;
+		const auto size = m_pendingSize;
+		// write without the lock so the other buffer can be filled
+		lock.unlock();
+		const bool written = (std::fwrite(data, 1, size, m_file) == size);
+		lock.lock();
+		if (written == false)
+			m_failed = true;
+		m_pendingData = nullptr;
+		m_condition.notify_all();
+	}
+}
\ No newline at end of file
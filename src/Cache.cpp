@@ -0,0 +1,602 @@
+#include <DWARFToCPP/Cache.h>
+#include <DWARFToCPP/SectionLoader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	constexpr std::string_view CacheMagic = "DWARF2CC";
+	// bump this whenever the layout of any concept changes
+	constexpr uint64_t CacheVersion = 4;
+
+	void AppendVarInt(std::string& out, uint64_t value) noexcept
+	{
+		while (value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	void AppendString(std::string& out, std::string_view str) noexcept
+	{
+		AppendVarInt(out, str.size());
+		out += str;
+	}
+
+	std::string ToHex(const uint8_t* data, size_t size) noexcept
+	{
+		constexpr std::string_view digits = "0123456789abcdef";
+		std::string hex;
+		hex.reserve(size * 2);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hex += digits[data[i] >> 4];
+			hex += digits[data[i] & 0xf];
+		}
+		return hex;
+	}
+
+	std::string HashToHex(uint64_t hash) noexcept
+	{
+		// most significant byte first, whatever the host's byte order
+		uint8_t bytes[sizeof(hash)];
+		for (size_t i = 0; i < sizeof(hash); ++i)
+			bytes[i] = static_cast<uint8_t>(hash >> (8 * (sizeof(hash) - 1 - i)));
+		return ToHex(bytes, sizeof(bytes));
+	}
+
+	// reads little-endian fields, failing rather than reading past the end
+	class ByteReader
+	{
+	public:
+		ByteReader(const uint8_t* data, size_t size, size_t offset) noexcept :
+			m_data(data), m_size(size), m_offset(offset)
+		{
+			if (m_offset > m_size)
+				Fail();
+		}
+
+		bool Valid() const noexcept { return m_valid; }
+		bool AtEnd() const noexcept { return m_offset >= m_size; }
+		size_t Offset() const noexcept { return m_offset; }
+
+		uint64_t ReadFixed(uint64_t size) noexcept
+		{
+			if (size > sizeof(uint64_t) || size > m_size - m_offset)
+			{
+				Fail();
+				return 0;
+			}
+			uint64_t value = 0;
+			for (size_t i = 0; i < size; ++i)
+				value |= static_cast<uint64_t>(m_data[m_offset + i]) << (8 * i);
+			m_offset += size;
+			return value;
+		}
+
+		uint64_t ReadULEB() noexcept
+		{
+			uint64_t value = 0;
+			for (size_t shift = 0; ; shift += 7)
+			{
+				if (m_offset >= m_size)
+				{
+					Fail();
+					return 0;
+				}
+				const auto byte = m_data[m_offset++];
+				if (shift < 64)
+					value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+		}
+
+		void Skip(uint64_t size) noexcept
+		{
+			if (size > m_size - m_offset)
+				Fail();
+			else
+				m_offset += size;
+		}
+
+		void SkipString() noexcept
+		{
+			const auto end = std::memchr(m_data + m_offset, 0, m_size - m_offset);
+			if (end == nullptr)
+				Fail();
+			else
+				m_offset = static_cast<size_t>(static_cast<const uint8_t*>(end) - m_data) + 1;
+		}
+	private:
+		void Fail() noexcept
+		{
+			m_valid = false;
+			m_offset = m_size;
+		}
+
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_offset;
+		bool m_valid = true;
+	};
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size) noexcept
+	{
+		// FNV-1a, so the key is the same on every platform
+		const auto bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3;
+		}
+		return hash;
+	}
+
+	std::string GetTempSuffix() noexcept
+	{
+		// other threads and processes may write the same cache at once
+		static std::atomic_uint64_t s_tempCount = 0;
+		uint64_t value = std::chrono::system_clock::now().time_since_epoch().count();
+		value ^= std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9e3779b97f4a7c15;
+		return HashToHex(value) + '-' + std::to_string(s_tempCount++);
+	}
+}
+
+std::string DWARFToCPP::GetCacheKey(const elf::elf& file, std::string_view salt) noexcept
+{
+	std::string key;
+	// the note is a name size, a descriptor size, a type, the
+	// name and the descriptor, each padded to 4 bytes
+	const auto& buildId = file.get_section(".note.gnu.build-id");
+	if (buildId.valid() == true && buildId.size() >= 12)
+	{
+		const auto note = static_cast<const uint8_t*>(buildId.data());
+		uint32_t nameSize, descSize;
+		std::memcpy(&nameSize, note, sizeof(nameSize));
+		std::memcpy(&descSize, note + 4, sizeof(descSize));
+		const size_t descOffset = 12 + ((nameSize + 3) & ~size_t(3));
+		if (descOffset + descSize <= buildId.size())
+			key = ToHex(note + descOffset, descSize);
+	}
+	if (key.empty() == true)
+	{
+		// hash the debug sections instead, which are all that is parsed.
+		// code and data can be far larger
+		uint64_t hash = 0xcbf29ce484222325;
+		for (const auto& section : file.sections())
+		{
+			const std::string_view name = section.get_name();
+			if (section.get_hdr().type == elf::sht::nobits ||
+				(name.starts_with(".debug_") == false && name.starts_with(".zdebug_") == false))
+				continue;
+			hash = HashBytes(hash, name.data(), name.size());
+			hash = HashBytes(hash, section.data(), section.size());
+		}
+		key = HashToHex(hash);
+	}
+	if (salt.empty() == false)
+	{
+		const uint64_t saltHash = HashBytes(0xcbf29ce484222325, salt.data(), salt.size());
+		key += '-' + HashToHex(saltHash);
+	}
+	return key;
+}
+
+std::optional<std::string> DWARFToCPP::GetUnitKey(const elf::elf& file,
+	dwarf::section_offset unitOffset, std::string_view salt) noexcept
+{
+	const auto& info = file.get_section(".debug_info");
+	const auto& abbrev = file.get_section(".debug_abbrev");
+	// compressed units aren't cached, since their offsets are
+	// into the decompressed data
+	if (info.valid() == false || abbrev.valid() == false ||
+		SectionLoader::IsCompressed(info) == true || SectionLoader::IsCompressed(abbrev) == true)
+		return std::nullopt;
+	const auto infoData = static_cast<const uint8_t*>(info.data());
+	const auto abbrevData = static_cast<const uint8_t*>(abbrev.data());
+	// the unit starts with its length, which is 64-bit if the 32-bit
+	// length is all ones, and its version
+	ByteReader header(infoData, info.size(), unitOffset);
+	uint64_t unitLength = header.ReadFixed(4);
+	size_t offsetSize = 4;
+	if (unitLength == 0xffffffff)
+	{
+		unitLength = header.ReadFixed(8);
+		offsetSize = 8;
+	}
+	const size_t headerOffset = header.Offset();
+	if (header.Valid() == false || unitLength > info.size() - headerOffset ||
+		unitLength < 2 + 2 + offsetSize)
+		return std::nullopt;
+	const size_t unitEnd = headerOffset + unitLength;
+	const auto version = header.ReadFixed(2);
+	// DWARF 5 adds the unit type and moves the address size
+	// before the abbreviation offset
+	uint64_t unitType = 0, addressSize = 0, abbrevOffset = 0;
+	if (version >= 5)
+	{
+		unitType = header.ReadFixed(1);
+		addressSize = header.ReadFixed(1);
+		abbrevOffset = header.ReadFixed(offsetSize);
+	}
+	else
+	{
+		abbrevOffset = header.ReadFixed(offsetSize);
+		addressSize = header.ReadFixed(1);
+	}
+	// skeleton and split units have a DWO id, type units a signature and type offset
+	if (unitType == 0x04 || unitType == 0x05)
+		header.Skip(8);
+	else if (unitType == 0x02 || unitType == 0x06)
+		header.Skip(8 + offsetSize);
+	if (header.Valid() == false || header.Offset() > unitEnd || abbrevOffset >= abbrev.size())
+		return std::nullopt;
+	// the abbreviation table ends at a zero code. each abbreviation is a
+	// code, a tag, a children flag and attribute-form pairs ending in zeros
+	std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint64_t>>> abbrevs;
+	ByteReader table(abbrevData, abbrev.size(), abbrevOffset);
+	while (table.AtEnd() == false)
+	{
+		const auto code = table.ReadULEB();
+		if (code == 0)
+			break;
+		table.ReadULEB();
+		table.Skip(1);
+		auto& attributes = abbrevs[code];
+		while (table.AtEnd() == false)
+		{
+			const auto name = table.ReadULEB();
+			const auto form = table.ReadULEB();
+			// DW_FORM_implicit_const stores its value in the table
+			if (form == 0x21)
+				table.ReadULEB();
+			if (name == 0 && form == 0)
+				break;
+			attributes.emplace_back(name, form);
+		}
+	}
+	if (table.Valid() == false)
+		return std::nullopt;
+	uint64_t hash = HashBytes(0xcbf29ce484222325, infoData + unitOffset, unitEnd - unitOffset);
+	hash = HashBytes(hash, abbrevData + abbrevOffset, table.Offset() - abbrevOffset);
+	// the unit only holds offsets of the strings it names, which stay
+	// the same when a string changes length at the end of the section.
+	// so the strings themselves are hashed too
+	const auto hashString = [&hash](const elf::section& section, uint64_t offset)
+	{
+		if (section.valid() == false || SectionLoader::IsCompressed(section) == true ||
+			offset >= section.size())
+			return false;
+		const auto str = static_cast<const char*>(section.data()) + offset;
+		const size_t length = strnlen(str, section.size() - offset);
+		hash = HashBytes(hash, str, std::min<size_t>(length + 1, section.size() - offset));
+		return true;
+	};
+	const auto& strings = file.get_section(".debug_str");
+	const auto& lineStrings = file.get_section(".debug_line_str");
+	std::vector<uint64_t> stringIndices;
+	// without DW_AT_str_offsets_base, the indices are into the first table
+	uint64_t stringOffsetsBase = (version >= 5) ? 2 * offsetSize : 0;
+	ByteReader dies(infoData, unitEnd, header.Offset());
+	while (dies.AtEnd() == false)
+	{
+		const auto code = dies.ReadULEB();
+		if (code == 0)
+			continue;
+		const auto abbrevIt = abbrevs.find(code);
+		if (abbrevIt == abbrevs.end())
+			return std::nullopt;
+		for (auto [name, form] : abbrevIt->second)
+		{
+			// DW_FORM_indirect names the form in place
+			while (form == 0x16 && dies.Valid() == true)
+				form = dies.ReadULEB();
+			uint64_t value = 0;
+			switch (form)
+			{
+			case 0x01: // addr
+				value = dies.ReadFixed(addressSize);
+				break;
+			case 0x0b: case 0x0c: case 0x11: case 0x25: case 0x29: // data1, flag, ref1, strx1, addrx1
+				value = dies.ReadFixed(1);
+				break;
+			case 0x05: case 0x12: case 0x26: case 0x2a: // data2, ref2, strx2, addrx2
+				value = dies.ReadFixed(2);
+				break;
+			case 0x27: case 0x2b: // strx3, addrx3
+				value = dies.ReadFixed(3);
+				break;
+			case 0x06: case 0x13: case 0x1c: case 0x28: case 0x2c: // data4, ref4, ref_sup4, strx4, addrx4
+				value = dies.ReadFixed(4);
+				break;
+			case 0x07: case 0x14: case 0x20: case 0x24: // data8, ref8, ref_sig8, ref_sup8
+				value = dies.ReadFixed(8);
+				break;
+			case 0x1e: // data16
+				dies.Skip(16);
+				break;
+			case 0x0e: case 0x17: case 0x1d: case 0x1f: case 0x1f20: case 0x1f21:
+				// strp, sec_offset, strp_sup, line_strp, GNU_ref_alt, GNU_strp_alt
+				value = dies.ReadFixed(offsetSize);
+				break;
+			case 0x10: // ref_addr, which was address sized in DWARF 2
+				value = dies.ReadFixed((version <= 2) ? addressSize : offsetSize);
+				break;
+			case 0x0d: case 0x0f: case 0x15: case 0x1a: case 0x1b: case 0x22: case 0x23:
+			case 0x1f01: case 0x1f02:
+				// sdata, udata, ref_udata, strx, addrx, loclistx, rnglistx,
+				// GNU_addr_index, GNU_str_index
+				value = dies.ReadULEB();
+				break;
+			case 0x0a: // block1
+				dies.Skip(dies.ReadFixed(1));
+				break;
+			case 0x03: // block2
+				dies.Skip(dies.ReadFixed(2));
+				break;
+			case 0x04: // block4
+				dies.Skip(dies.ReadFixed(4));
+				break;
+			case 0x09: case 0x18: // block, exprloc
+				dies.Skip(dies.ReadULEB());
+				break;
+			case 0x08: // string, which is hashed with the unit
+				dies.SkipString();
+				break;
+			case 0x19: case 0x21: // flag_present, implicit_const
+				break;
+			default:
+				// the size of an unknown form isn't known, so neither is the next attribute
+				return std::nullopt;
+			}
+			if (form == 0x0e && hashString(strings, value) == false)
+				return std::nullopt;
+			if (form == 0x1f && hashString(lineStrings, value) == false)
+				return std::nullopt;
+			if (form == 0x1a || (form >= 0x25 && form <= 0x28) || form == 0x1f02)
+				stringIndices.push_back(value);
+			if (name == 0x72) // str_offsets_base
+				stringOffsetsBase = value;
+		}
+		if (dies.Valid() == false)
+			return std::nullopt;
+	}
+	if (stringIndices.empty() == false)
+	{
+		const auto& stringOffsets = file.get_section(".debug_str_offsets");
+		if (stringOffsets.valid() == false || SectionLoader::IsCompressed(stringOffsets) == true)
+			return std::nullopt;
+		for (const auto index : stringIndices)
+		{
+			if (stringOffsetsBase > stringOffsets.size() ||
+				index >= (stringOffsets.size() - stringOffsetsBase) / offsetSize)
+				return std::nullopt;
+			ByteReader entry(static_cast<const uint8_t*>(stringOffsets.data()),
+				stringOffsets.size(), stringOffsetsBase + index * offsetSize);
+			const auto offset = entry.ReadFixed(offsetSize);
+			if (entry.Valid() == false || hashString(strings, offset) == false)
+				return std::nullopt;
+		}
+	}
+	hash = HashBytes(hash, salt.data(), salt.size());
+	return HashToHex(hash);
+}
+
+std::optional<std::string> DWARFToCPP::GetUnitHash(const elf::elf& file,
+	dwarf::section_offset unitOffset) noexcept
+{
+	const auto& info = file.get_section(".debug_info");
+	if (info.valid() == false || SectionLoader::IsCompressed(info) == true)
+		return std::nullopt;
+	const auto infoData = static_cast<const uint8_t*>(info.data());
+	ByteReader header(infoData, info.size(), unitOffset);
+	uint64_t unitLength = header.ReadFixed(4);
+	if (unitLength == 0xffffffff)
+		unitLength = header.ReadFixed(8);
+	if (header.Valid() == false || unitLength > info.size() - header.Offset())
+		return std::nullopt;
+	return HashToHex(HashBytes(0xcbf29ce484222325, infoData + unitOffset,
+		header.Offset() + unitLength - unitOffset));
+}
+
+// writer
+
+void CacheWriter::Write(uint64_t value) noexcept
+{
+	AppendVarInt(m_payload, value);
+}
+
+void CacheWriter::WriteSigned(int64_t value) noexcept
+{
+	// zigzag encode so small negative numbers stay small
+	Write((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void CacheWriter::WriteString(InternedString str) noexcept
+{
+	const auto [stringIt, inserted] = m_stringIndices.try_emplace(str, m_strings.size());
+	if (inserted == true)
+		m_strings.push_back(str);
+	Write(stringIt->second);
+}
+
+void CacheWriter::WriteReference(const Named* named) noexcept
+{
+	// 0 is reserved for nullptr
+	if (named == nullptr)
+	{
+		Write(0);
+		return;
+	}
+	const auto [nodeIt, inserted] = m_nodeIndices.try_emplace(named, m_nodes.size());
+	if (inserted == true)
+		m_nodes.push_back(named);
+	Write(nodeIt->second + 1);
+}
+
+std::optional<std::string> CacheWriter::Finish(const std::string& path, std::string_view key) const noexcept
+{
+	std::string header(CacheMagic);
+	AppendVarInt(header, CacheVersion);
+	AppendString(header, key);
+	AppendVarInt(header, m_strings.size());
+	for (const auto str : m_strings)
+		AppendString(header, str.View());
+	AppendVarInt(header, m_nodes.size());
+	for (const auto node : m_nodes)
+	{
+		header += static_cast<char>(node->GetType());
+		if (node->GetType() == Named::Type::Typed)
+			header += static_cast<char>(static_cast<const Typed*>(node)->GetTypeCode());
+	}
+	AppendVarInt(header, m_payload.size());
+	// write to a temporary file first so that a reader never sees
+	// a partially written cache
+	const std::string tempPath = path + '.' + GetTempSuffix() + ".tmp";
+	std::error_code error;
+	{
+		std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+		if (outFile.good() == false)
+			return "Failed to open cache file " + tempPath;
+		outFile.write(header.data(), header.size());
+		outFile.write(m_payload.data(), m_payload.size());
+		if (outFile.good() == false)
+		{
+			outFile.close();
+			std::filesystem::remove(tempPath, error);
+			return "Failed to write cache file " + tempPath;
+		}
+	}
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		const auto message = error.message();
+		std::filesystem::remove(tempPath, error);
+		return "Failed to write cache file " + path + ": " + message;
+	}
+	return std::nullopt;
+}
+
+// reader
+
+std::optional<std::string> CacheReader::Open(const std::string& path, std::string_view key) noexcept
+{
+	std::ifstream inFile(path, std::ios::binary);
+	if (inFile.good() == false)
+		return "Failed to open cache file " + path;
+	m_data.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+	if (std::string_view(m_data).starts_with(CacheMagic) == false)
+		return "File " + path + " is not a cache";
+	m_offset = CacheMagic.size();
+	if (Read() != CacheVersion)
+		return "Cache " + path + " is from another version";
+	if (ReadView() != key)
+		return "Cache " + path + " is for another file";
+	const auto stringCount = ReadCount();
+	m_stringTable.reserve(stringCount);
+	for (uint64_t i = 0; i < stringCount && m_failed == false; ++i)
+		m_stringTable.push_back(m_strings.Intern(ReadView()));
+	const auto nodeCount = ReadCount();
+	m_nodeKinds.reserve(nodeCount);
+	for (uint64_t i = 0; i < nodeCount && m_failed == false; ++i)
+	{
+		const auto type = static_cast<Named::Type>(Read());
+		const auto typeCode = (type == Named::Type::Typed) ?
+			static_cast<Typed::TypeCode>(Read()) : Typed::TypeCode{};
+		m_nodeKinds.emplace_back(type, typeCode);
+	}
+	if (Read() != m_data.size() - m_offset)
+		m_failed = true;
+	return Error();
+}
+
+uint64_t CacheReader::Read() noexcept
+{
+	uint64_t value = 0;
+	for (size_t shift = 0; m_failed == false; shift += 7)
+	{
+		if (m_offset >= m_data.size() || shift > 63)
+		{
+			m_failed = true;
+			break;
+		}
+		const auto byte = static_cast<uint8_t>(m_data[m_offset++]);
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+	return 0;
+}
+
+int64_t CacheReader::ReadSigned() noexcept
+{
+	const auto value = Read();
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+uint64_t CacheReader::ReadCount() noexcept
+{
+	const auto count = Read();
+	if (count > m_data.size() - m_offset)
+	{
+		m_failed = true;
+		return 0;
+	}
+	return count;
+}
+
+InternedString CacheReader::ReadString() noexcept
+{
+	const auto index = Read();
+	if (index >= m_stringTable.size())
+	{
+		m_failed = true;
+		return InternedString();
+	}
+	return m_stringTable[index];
+}
+
+std::string_view CacheReader::ReadView() noexcept
+{
+	const auto size = Read();
+	if (m_failed == true || size > m_data.size() - m_offset)
+	{
+		m_failed = true;
+		return std::string_view();
+	}
+	const auto view = std::string_view(m_data).substr(m_offset, size);
+	m_offset += size;
+	return view;
+}
+
+Named* CacheReader::ReadNode() noexcept
+{
+	const auto index = Read();
+	if (index == 0)
+		return nullptr;
+	if (index > m_nodes.size())
+	{
+		m_failed = true;
+		return nullptr;
+	}
+	return m_nodes[index - 1];
+}
+
+std::optional<std::string> CacheReader::Error() const noexcept
+{
+	if (m_failed == true)
+		return "The cache is corrupt";
+	return std::nullopt;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <DWARFToCPP/NameIndex.h>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	/// @brief Calls a function for each concept directly in a namespace or class
+	/// @param named A named concept
+	/// @param func The function
+	template<typename Func>
+	void ForEachChild(const Named& named, Func&& func) noexcept
+	{
+		if (named.GetType() == Named::Type::Namespace)
+		{
+			for (const auto& [name, child] : static_cast<const Namespace&>(named).GetSortedConcepts())
+			{
+				// streamed concepts only leave a placeholder behind
+				if (child->GetType() != Named::Type::Ignored)
+					func(child);
+			}
+		}
+		else if (named.GetType() == Named::Type::Typed &&
+			static_cast<const Typed&>(named).GetTypeCode() == Typed::TypeCode::Class)
+		{
+			// only nested types, since member names are not unique
+			for (const auto& [member, accessibility] : static_cast<const Class&>(named).GetMembers())
+			{
+				if (member->GetType() == Named::Type::Typed && member->GetName().empty() == false)
+					func(member);
+			}
+		}
+	}
+}
+
+void NameIndex::Build(const Namespace& globalNamespace) noexcept
+{
+	m_entries.clear();
+	m_names.clear();
+	// names are stored as offsets until every name is known, since
+	// m_names moves while it grows
+	struct PendingEntry
+	{
+		size_t nameOffset;
+		size_t nameSize;
+		const Named* named;
+	};
+	std::vector<PendingEntry> pending;
+	std::vector<std::pair<uint32_t, uint32_t>> children;
+	ForEachChild(globalNamespace, [&](const Named* child)
+		{
+			pending.push_back(PendingEntry{ m_names.size(), child->GetName().size(), child });
+			m_names += child->GetName();
+		});
+	m_globalEnd = static_cast<uint32_t>(pending.size());
+	// expand scopes breadth first, so each one's children are appended together
+	for (size_t entryIndex = 0; entryIndex < pending.size(); ++entryIndex)
+	{
+		const auto childBegin = static_cast<uint32_t>(pending.size());
+		const auto scope = pending[entryIndex];
+		const auto scopeName = m_names.substr(scope.nameOffset, scope.nameSize);
+		ForEachChild(*scope.named, [&](const Named* child)
+			{
+				const auto nameOffset = m_names.size();
+				m_names += scopeName;
+				m_names += "::";
+				m_names += child->GetName();
+				pending.push_back(PendingEntry{ nameOffset, m_names.size() - nameOffset, child });
+			});
+		children.emplace_back(childBegin, static_cast<uint32_t>(pending.size()));
+	}
+	m_entries.reserve(pending.size());
+	for (size_t entryIndex = 0; entryIndex < pending.size(); ++entryIndex)
+	{
+		const auto name = std::string_view(m_names).substr(pending[entryIndex].nameOffset,
+			pending[entryIndex].nameSize);
+		m_entries.push_back(Entry{ name, pending[entryIndex].named,
+			std::hash<std::string_view>()(name), children[entryIndex].first,
+			children[entryIndex].second });
+	}
+	m_sorted.resize(m_entries.size());
+	for (uint32_t entryIndex = 0; entryIndex < m_sorted.size(); ++entryIndex)
+		m_sorted[entryIndex] = entryIndex;
+	std::sort(m_sorted.begin(), m_sorted.end(), [this](uint32_t left, uint32_t right)
+		{
+			return m_entries[left].name < m_entries[right].name;
+		});
+	// the same type may be nested in a class and be in a namespace under
+	// the same name, in which case the first one found is kept
+	m_slots.assign(std::bit_ceil(std::max<size_t>(m_entries.size() * 2, 16)), None);
+	const size_t mask = m_slots.size() - 1;
+	for (uint32_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+	{
+		const auto& entry = m_entries[entryIndex];
+		for (size_t slot = entry.hash & mask;; slot = (slot + 1) & mask)
+		{
+			if (m_slots[slot] == None)
+			{
+				m_slots[slot] = entryIndex;
+				break;
+			}
+			const auto& existing = m_entries[m_slots[slot]];
+			if (existing.hash == entry.hash && existing.name == entry.name)
+				break;
+		}
+	}
+}
+
+const Named* NameIndex::Find(std::string_view qualifiedName) const noexcept
+{
+	const auto entryIndex = FindEntry(qualifiedName);
+	return (entryIndex != None) ? m_entries[entryIndex].named : nullptr;
+}
+
+std::span<const NameIndex::Entry> NameIndex::GetChildren(std::string_view scope) const noexcept
+{
+	if (scope.empty() == true)
+		return std::span(m_entries).first(m_globalEnd);
+	const auto entryIndex = FindEntry(scope);
+	if (entryIndex == None)
+		return {};
+	const auto& entry = m_entries[entryIndex];
+	return std::span(m_entries).subspan(entry.childBegin, entry.childEnd - entry.childBegin);
+}
+
+uint32_t NameIndex::FindEntry(std::string_view qualifiedName) const noexcept
+{
+	if (m_slots.empty() == true)
+		return None;
+	const size_t hash = std::hash<std::string_view>()(qualifiedName);
+	const size_t mask = m_slots.size() - 1;
+	// the table is never full, so probing always reaches an empty slot
+	for (size_t slot = hash & mask; m_slots[slot] != None; slot = (slot + 1) & mask)
+	{
+		const auto& entry = m_entries[m_slots[slot]];
+		if (entry.hash == hash && entry.name == qualifiedName)
+			return m_slots[slot];
+	}
+	return None;
+}
+
+std::vector<uint32_t>::const_iterator NameIndex::LowerBound(std::string_view prefix) const noexcept
+{
+	return std::lower_bound(m_sorted.begin(), m_sorted.end(), prefix,
+		[this](uint32_t entryIndex, std::string_view value)
+		{
+			return m_entries[entryIndex].name < value;
+		});
+}
\ No newline at end of file
@@ -1,83 +1,163 @@
 #include <DWARFToCPP/Parser.h>
+#include <DWARFToCPP/Accelerator.h>
+#include <DWARFToCPP/Attributes.h>
+#include <DWARFToCPP/BufferedWriter.h>
+#include <DWARFToCPP/Cache.h>
+#include <DWARFToCPP/SectionLoader.h>
+#include <DWARFToCPP/SplitUnits.h>
+#include <DWARFToCPP/TaskPool.h>
+#include <DWARFToCPP/Tracer.h>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <ranges>
+#include <set>
 #include <stack>
 #include <unordered_set>
 
 using namespace DWARFToCPP;
 
+namespace
+{
+	/// @brief Finds the definitions of a name in accelerator tables
+	/// @param index The tables
+	/// @param name The qualified name
+	/// @param locations The locations to add the definitions to
+	/// @return Whether or not the tables could be read
+	bool FindDefinitions(const AcceleratorIndex& index, std::string_view name,
+		std::vector<AcceleratorIndex::Location>& locations) noexcept
+	{
+		// tables store either qualified or unqualified names, so look up
+		// both. the name is the part after the last scope outside of any
+		// template arguments
+		size_t nameStart = 0, depth = 0;
+		for (size_t i = 0; i < name.size(); ++i)
+		{
+			if (name[i] == '<')
+				++depth;
+			else if (name[i] == '>' && depth > 0)
+				--depth;
+			else if (depth == 0 && name.compare(i, 2, "::") == 0)
+				nameStart = i + 2;
+		}
+		return index.Find(name, locations) == true &&
+			(nameStart == 0 || index.Find(name.substr(nameStart), locations) == true);
+	}
+}
+
 // types
 
 std::optional<std::string> Array::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
+	const Attributes attributes(die);
 	// find the type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "An array was missing a type!";
 	// parse the type
 	auto parsedType = parser.ParseDIE(type.as_reference());
 	if (parsedType.has_value() == false)
 		return std::move(parsedType.error());
-	if (parsedType->get()->GetType() != Type::Typed)
+	if (parsedType.value()->GetType() != Type::Typed)
 		return "An array's type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+	m_type = static_cast<Typed*>(parsedType.value());
 	// get the child, which contains size
 	auto child = *die.begin();
 	if (child.tag != dwarf::DW_TAG::subrange_type)
 		return "An array was missing its subrange info!";
 	// parse the size
-	auto size = child.resolve(dwarf::DW_AT::upper_bound);
+	auto size = Attributes(child).Resolve(dwarf::DW_AT::upper_bound);
 	if (size.valid() == false)
 		return "An array's subrange info was missing the size!";
 	// the subrange size + 1 is the array's size
 	m_size = size.as_uconstant() + 1;
-	SetName(m_type.lock()->GetName() + '[' + std::to_string(m_size) + ']');
 	return std::nullopt;
 }
 
-void Array::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+std::optional<std::string> Array::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern(std::string(m_type->GetName()) + '[' + std::to_string(m_size) + ']'));
+	return std::nullopt;
+}
+
+void Array::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void Array::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.Write(m_size);
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> Array::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_size = reader.Read();
+	m_type = reader.ReadReference<Typed>();
+	return reader.Error();
 }
 
 std::optional<std::string> BasicType::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == false)
 		return "A basic type was missing a name!";
-	SetName(name.as_string());
+	SetName(parser.Intern(name.as_cstr()));
 	return std::nullopt;
 }
 
-void BasicType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void BasicType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void BasicType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+}
 
+std::optional<std::string> BasicType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	return reader.Error();
 }
 
 std::optional<std::string> Class::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
 	m_classType = die.tag;
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	m_declaration = attributes.Has(dwarf::DW_AT::declaration);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	std::string className;
 	if (name.valid() == true)
-		SetName(name.as_string());
+		SetName(parser.Intern(name.as_cstr()));
 	else
-		SetName(std::to_string(std::hash<void*>()(this)));
+		SetName(parser.Intern(parser.GetAnonymousName(die)));
 	bool publicDefault = (die.tag != dwarf::DW_TAG::class_type);
 	// a namespace contains many children. parse each one
 	for (auto child : die)
 	{
 		// if accessibility is unstated, it uses the defaults
 		Accessibility accessibility = (publicDefault == true) ? Accessibility::Public : Accessibility::Private;
-		auto accessibilityAttr = child.resolve(dwarf::DW_AT::accessibility);
+		const Attributes childAttributes(child);
+		auto accessibilityAttr = childAttributes.Resolve(dwarf::DW_AT::accessibility);
 		if (accessibilityAttr.valid() == true)
 			accessibility = static_cast<Accessibility>(accessibilityAttr.as_uconstant());
 		if (child.tag == dwarf::DW_TAG::inheritance)
 		{
-			auto inheritanceType = child.resolve(dwarf::DW_AT::type);
+			auto inheritanceType = childAttributes.Resolve(dwarf::DW_AT::type);
 			if (inheritanceType.valid() == false)
 				return "An class inheritance did not have a type!";
 			auto parsedInheritanceType = parser.ParseDIE(inheritanceType.as_reference());
@@ -85,12 +165,11 @@ std::optional<std::string> Class::ParseDIE(Parser& parser,
 				return std::move(parsedInheritanceType.error());
 			if (parsedInheritanceType.value()->GetType() != Type::Typed)
 				return "A class inheritance was not a type!";
-			const auto parentClass = std::static_pointer_cast<Typed>(
-				std::move(parsedInheritanceType.value()));
+			const auto parentClass = static_cast<Typed*>(parsedInheritanceType.value());
 			// ensure it is also a class
 			if (parentClass->GetTypeCode() != TypeCode::Class)
 				return "A class inheritance was not a class!";
-			m_parentClasses.emplace_back(std::static_pointer_cast<Class>(parentClass), accessibility);
+			m_parentClasses.emplace_back(static_cast<Class*>(parentClass), accessibility);
 			continue;
 		}
 		// the child is a type. parse it
@@ -104,8 +183,7 @@ std::optional<std::string> Class::ParseDIE(Parser& parser,
 			child.tag == dwarf::DW_TAG::template_value_parameter)
 		{
 			// it is guaranteed to be a named type
-			m_templateParameters.push_back(std::static_pointer_cast<Value>(
-				std::move(parsedChild.value())));
+			m_templateParameters.push_back(static_cast<Value*>(parsedChild.value()));
 			continue;
 		}
 		// it's a normal member. add the relationship and store the member
@@ -115,7 +193,7 @@ std::optional<std::string> Class::ParseDIE(Parser& parser,
 	return std::nullopt;
 }
 
-void Class::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Class::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	PrintIndents(outFile, indentLevel);
 	outFile << ToString(m_classType) << ' ' << GetName() << ' ';
@@ -127,7 +205,7 @@ void Class::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
 			if (it != m_parentClasses.begin())
 				outFile << ", ";
 			outFile << ToString(it->second) << ' ';
-			outFile << it->first.lock()->GetName();
+			outFile << it->first->GetName();
 		}
 	}
 	outFile << '\n';
@@ -144,12 +222,57 @@ void Class::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
 			outFile << ToString(memberPair.second) << ":\n";
 			lastAccessibility = memberPair.second;
 		}
-		memberPair.first.lock()->PrintToFile(outFile, indentLevel + 1);
+		memberPair.first->PrintToFile(outFile, indentLevel + 1);
 	}
 	PrintIndents(outFile, indentLevel);
 	outFile << "};\n";
 }
 
+void Class::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.Write(static_cast<uint64_t>(m_classType));
+	writer.Write(m_declaration);
+	writer.Write(m_members.size());
+	for (const auto& [member, accessibility] : m_members)
+	{
+		writer.WriteReference(member);
+		writer.Write(static_cast<uint64_t>(accessibility));
+	}
+	writer.Write(m_parentClasses.size());
+	for (const auto& [parentClass, accessibility] : m_parentClasses)
+	{
+		writer.WriteReference(parentClass);
+		writer.Write(static_cast<uint64_t>(accessibility));
+	}
+	writer.Write(m_templateParameters.size());
+	for (const auto templateParameter : m_templateParameters)
+		writer.WriteReference(templateParameter);
+}
+
+std::optional<std::string> Class::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_classType = static_cast<dwarf::DW_TAG>(reader.Read());
+	m_declaration = (reader.Read() != 0);
+	const auto memberCount = reader.ReadCount();
+	for (uint64_t i = 0; i < memberCount; ++i)
+	{
+		const auto member = reader.ReadReference<Named>();
+		m_members.emplace_back(member, static_cast<Accessibility>(reader.Read()));
+	}
+	const auto parentCount = reader.ReadCount();
+	for (uint64_t i = 0; i < parentCount; ++i)
+	{
+		const auto parentClass = reader.ReadReference<Class>();
+		m_parentClasses.emplace_back(parentClass, static_cast<Accessibility>(reader.Read()));
+	}
+	const auto templateParameterCount = reader.ReadCount();
+	for (uint64_t i = 0; i < templateParameterCount; ++i)
+		m_templateParameters.push_back(reader.ReadReference<Value>());
+	return reader.Error();
+}
+
 std::string Class::ToString(Accessibility accessibility) noexcept
 {
 	switch (accessibility)
@@ -181,8 +304,9 @@ std::string Class::ToString(dwarf::DW_TAG classType) noexcept
 std::optional<std::string> ConstType::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
+	const Attributes attributes(die);
 	// parse the embedded type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == true)
 	{
 		auto parsedType = parser.ParseDIE(type.as_reference());
@@ -190,26 +314,45 @@ std::optional<std::string> ConstType::ParseDIE(Parser& parser,
 			return std::move(parsedType.error());
 		if (parsedType.value()->GetType() != Type::Typed)
 			return "A const type was not a type!";
-		m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+		m_type = static_cast<Typed*>(parsedType.value());
 	}
-	SetName("const " + (m_type.has_value() == true ? m_type->lock()->GetName() : "void"));
 	return std::nullopt;
 }
 
-void ConstType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+std::optional<std::string> ConstType::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern("const " + std::string(m_type != nullptr ? m_type->GetName() : "void")));
+	return std::nullopt;
+}
+
+void ConstType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void ConstType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> ConstType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Named>();
+	return reader.Error();
 }
 
 std::optional<std::string> Enum::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	// enums dont have to have names
 	if (name.valid() == true)
-		SetName(name.as_string());
+		SetName(parser.Intern(name.as_cstr()));
 	else
-		SetName(std::to_string(std::hash<void*>()(this)));
+		SetName(parser.Intern(parser.GetAnonymousName(die)));
 	// parse the enumerators
 	for (auto child : die)
 	{
@@ -218,21 +361,19 @@ std::optional<std::string> Enum::ParseDIE(Parser& parser,
 			return std::move(enumerator.error());
 		if (enumerator.value()->GetType() != Type::Enumerator)
 			return "An enum had a non-enumerator child!";
-		m_enumerators.push_back(std::static_pointer_cast<Enumerator>(
-			std::move(enumerator.value())));
+		m_enumerators.push_back(static_cast<Enumerator*>(enumerator.value()));
 	}
 	return std::nullopt;
 }
 
-void Enum::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Enum::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	PrintIndents(outFile, indentLevel);
 	outFile << "enum " << GetName() << '\n';
 	PrintIndents(outFile, indentLevel);
 	outFile << "{\n";
-	for (const auto& enumeratorPtr : m_enumerators)
+	for (const auto enumerator : m_enumerators)
 	{
-		auto enumerator = enumeratorPtr.lock();
 		PrintIndents(outFile, indentLevel + 1);
 		outFile << enumerator->GetName() << " = ";
 		if (enumerator->GetValue().index() == 0)
@@ -245,14 +386,32 @@ void Enum::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
 	outFile << "};\n";
 }
 
+void Enum::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.Write(m_enumerators.size());
+	for (const auto enumerator : m_enumerators)
+		writer.WriteReference(enumerator);
+}
+
+std::optional<std::string> Enum::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	const auto enumeratorCount = reader.ReadCount();
+	for (uint64_t i = 0; i < enumeratorCount; ++i)
+		m_enumerators.push_back(reader.ReadReference<Enumerator>());
+	return reader.Error();
+}
+
 std::optional<std::string> Enumerator::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == false)
 		return "An enumerator was missing a name!";
-	SetName(name.as_string());
-	auto value = die.resolve(dwarf::DW_AT::const_value);
+	SetName(parser.Intern(name.as_cstr()));
+	auto value = attributes.Resolve(dwarf::DW_AT::const_value);
 	if (value.valid() == false)
 		return "An enumerator was missing a value!";
 	if (value.get_type() == dwarf::value::type::sconstant)
@@ -265,9 +424,29 @@ std::optional<std::string> Enumerator::ParseDIE(Parser& parser,
 	return std::nullopt;
 }
 
-void Enumerator::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Enumerator::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void Enumerator::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.Write(m_value.index());
+	if (m_value.index() == 0)
+		writer.Write(std::get<0>(m_value));
+	else
+		writer.WriteSigned(std::get<1>(m_value));
+}
 
+std::optional<std::string> Enumerator::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	if (reader.Read() == 0)
+		m_value = reader.Read();
+	else
+		m_value = reader.ReadSigned();
+	return reader.Error();
 }
 
 std::optional<std::string> Ignored::ParseDIE(Parser& parser,
@@ -277,12 +456,23 @@ std::optional<std::string> Ignored::ParseDIE(Parser& parser,
 	return std::nullopt;
 }
 
-void Ignored::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Ignored::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void Ignored::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+}
 
+std::optional<std::string> Ignored::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	return reader.Error();
 }
 
-void Named::PrintIndents(std::ofstream& outFile, size_t indentLevel) noexcept
+void Named::PrintIndents(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	for (size_t i = 0; i < indentLevel; ++i)
 		outFile << '\t';
@@ -293,11 +483,12 @@ std::optional<std::string> NamedType::ParseDIE(Parser& parser,
 {
 	// the name is actually kinda misleading. it may or
 	// may not be named
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == true)
-		SetName(name.as_string());
+		SetName(parser.Intern(name.as_cstr()));
 	// it does, however, have a base type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A named type did not have a type!";
 	auto parsedType = parser.ParseDIE(type.as_reference());
@@ -305,23 +496,39 @@ std::optional<std::string> NamedType::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A named type's type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+	m_type = static_cast<Typed*>(parsedType.value());
 	return std::nullopt;
 }
 
-void NamedType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void NamedType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void NamedType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> NamedType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Typed>();
+	return reader.Error();
 }
 
-std::optional<std::string> Namespace::AddNamed(Parser& parser, std::shared_ptr<Named> named) noexcept
+std::optional<std::string> Namespace::AddNamed(Parser& parser, Named* named) noexcept
 {
 	if (named == nullptr)
 		return std::nullopt;
-	const auto& name = named->GetName();
+	const auto name = named->GetInternedName();
 	// just ignore empty names
-	if (name.empty() == true)
+	if (name.Empty() == true)
 		return std::nullopt;
+	// only merges into the owning parser are counted, since units
+	// add to their namespaces from many threads
+	const bool counted = (parser.m_owner == nullptr);
 	// see if it already exists
 	const auto conceptIt = m_namedConcepts.find(name);
 	if (conceptIt == m_namedConcepts.end())
@@ -329,57 +536,192 @@ std::optional<std::string> Namespace::AddNamed(Parser& parser, std::shared_ptr<N
 		// add the relationship if this is not the global namespace
 		if (GetName().empty() == false)
 			parser.AddParent(*named, *this);
-		m_namedConcepts.emplace(name, std::move(named));
+		m_namedConcepts.emplace(name, named);
+		if (counted == true)
+			++parser.m_statistics.conceptsAdded;
 		return std::nullopt;
 	}
 	// if it's not a namespace, it's likely just included by multiple files
 	if (named->GetType() != Type::Namespace)
+	{
+		if (Supersedes(*named, *conceptIt->second) == true)
+		{
+			if (GetName().empty() == false)
+				parser.AddParent(*named, *this);
+			conceptIt->second = named;
+		}
+		else if (counted == true)
+			++parser.m_statistics.duplicatesSkipped;
 		return std::nullopt;
-	// lock the existing concept and append the new list
-	auto existingConcept = conceptIt->second.lock();
+	}
+	// append the new list to the existing namespace
+	auto existingConcept = conceptIt->second;
 	if (named->GetType() != existingConcept->GetType())
-		return "Symbol " + name + " in namespace " + GetName() + " type mismatch";
-	auto existingNamespace = std::static_pointer_cast<Namespace>(std::move(existingConcept));
-	auto newNamespace = std::static_pointer_cast<Namespace>(std::move(named));
-	existingNamespace->m_namedConcepts.insert(newNamespace->m_namedConcepts.begin(), 
-		newNamespace->m_namedConcepts.end());
+		return "Symbol " + std::string(name.View()) + " in namespace " +
+			std::string(GetName()) + " type mismatch";
+	auto existingNamespace = static_cast<Namespace*>(existingConcept);
+	auto newNamespace = static_cast<Namespace*>(named);
+	if (counted == true)
+		++parser.m_statistics.namespacesMerged;
+	for (const auto& [childName, child] : newNamespace->m_namedConcepts)
+	{
+		const auto [childIt, added] = existingNamespace->m_namedConcepts.emplace(childName, child);
+		if (added == false && Supersedes(*child, *childIt->second) == true)
+			childIt->second = child;
+	}
+	return std::nullopt;
+}
+
+bool Namespace::Supersedes(const Named& named, const Named& existing) noexcept
+{
+	const auto isClass = [](const Named& candidate)
+	{
+		return candidate.GetType() == Type::Typed &&
+			static_cast<const Typed&>(candidate).GetTypeCode() == Typed::TypeCode::Class;
+	};
+	return isClass(named) == true && isClass(existing) == true &&
+		static_cast<const Class&>(existing).IsDeclaration() == true &&
+		static_cast<const Class&>(named).IsDeclaration() == false;
+}
+
+void Namespace::RekeyConcepts(Parser& parser) noexcept
+{
+	std::vector<Named*> renamed;
+	for (auto conceptIt = m_namedConcepts.begin(); conceptIt != m_namedConcepts.end();)
+	{
+		if (conceptIt->first != conceptIt->second->GetInternedName())
+		{
+			renamed.push_back(conceptIt->second);
+			conceptIt = m_namedConcepts.erase(conceptIt);
+		}
+		else
+			++conceptIt;
+	}
+	// namespace names are never derived, so nothing is merged here
+	for (const auto named : renamed)
+		AddNamed(parser, named);
+}
+
+std::optional<std::string> Namespace::AddStreamed(Parser& parser, Parser& unitParser,
+	Named* named, Namespace& emitted) noexcept
+{
+	if (named == nullptr)
+		return std::nullopt;
+	const auto name = named->GetInternedName();
+	// just ignore empty names
+	if (name.Empty() == true)
+		return std::nullopt;
+	const auto conceptIt = m_namedConcepts.find(name);
+	// printed concepts are freed, so only their names are kept, and
+	// apart from the namespace so it never holds a freed concept
+	auto& streamedNames = parser.m_streamedNames[this];
+	if (named->GetType() != Type::Namespace)
+	{
+		// if it exists, it's likely just included by multiple files
+		if (conceptIt != m_namedConcepts.end() || streamedNames.insert(name).second == false)
+		{
+			++parser.m_statistics.duplicatesSkipped;
+			return std::nullopt;
+		}
+		emitted.m_namedConcepts.emplace(name, named);
+		++parser.m_statistics.conceptsAdded;
+		return std::nullopt;
+	}
+	// the namespace is freed with its unit, so keep a copy
+	if (streamedNames.contains(name) == true)
+		return "Symbol " + std::string(name.View()) + " in namespace " +
+			std::string(GetName()) + " type mismatch";
+	Namespace* existingNamespace;
+	if (conceptIt == m_namedConcepts.end())
+	{
+		existingNamespace = parser.m_arena.Create<Namespace>();
+		existingNamespace->SetName(name);
+		m_namedConcepts.emplace(name, existingNamespace);
+		++parser.m_statistics.conceptsAdded;
+	}
+	else
+	{
+		if (conceptIt->second->GetType() != Type::Namespace)
+			return "Symbol " + std::string(name.View()) + " in namespace " +
+				std::string(GetName()) + " type mismatch";
+		existingNamespace = static_cast<Namespace*>(conceptIt->second);
+		++parser.m_statistics.namespacesMerged;
+	}
+	// only print what the namespace did not already have
+	auto emittedNamespace = unitParser.m_arena.Create<Namespace>();
+	emittedNamespace->SetName(name);
+	for (const auto& namedPair : static_cast<Namespace*>(named)->m_namedConcepts)
+	{
+		if (auto error = existingNamespace->AddStreamed(parser, unitParser,
+			namedPair.second, *emittedNamespace); error.has_value() == true)
+			return std::move(error);
+	}
+	if (emittedNamespace->m_namedConcepts.empty() == false)
+		emitted.m_namedConcepts.emplace(name, emittedNamespace);
 	return std::nullopt;
 }
 
-std::optional<std::shared_ptr<const Named>> Namespace::GetNamedConcept(
-	const std::string& name) const noexcept
+std::vector<std::pair<InternedString, Named*>> Namespace::GetSortedConcepts() const noexcept
+{
+	std::vector<std::pair<InternedString, Named*>> concepts(m_namedConcepts.begin(),
+		m_namedConcepts.end());
+	std::sort(concepts.begin(), concepts.end(), [](const auto& lhs, const auto& rhs)
+		{
+			return lhs.first.View() < rhs.first.View();
+		});
+	return concepts;
+}
+
+const Named* Namespace::GetNamedConcept(InternedString name) const noexcept
 {
 	const auto conceptIt = m_namedConcepts.find(name);
 	if (conceptIt == m_namedConcepts.end())
-		return std::nullopt;
-	return conceptIt->second.lock();
+		return nullptr;
+	return conceptIt->second;
 }
 
 std::optional<std::string> Namespace::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == true)
-		SetName(name.as_string());
+		SetName(parser.Intern(name.as_cstr()));
 	else
-		SetName("::");
+		SetName(parser.Intern("::"));
 	// a namespace contains many children. parse each one
 	for (const auto& child : die)
 	{
+		// skip anything unrelated to the roots
+		if (parser.IsWanted(child) == false)
+			continue;
 		// parse the child
 		auto parsedChild = parser.ParseDIE(child);
 		if (parsedChild.has_value() == false)
 			return std::move(parsedChild.error());
-		auto error = AddNamed(parser, parsedChild.value());
+		m_children.push_back(parsedChild.value());
+	}
+	return std::nullopt;
+}
+
+std::optional<std::string> Namespace::Finalize(Parser& parser) noexcept
+{
+	// the children are named now, so they can be added
+	for (const auto child : m_children)
+	{
+		auto error = AddNamed(parser, child);
 		if (error.has_value() == true)
 			return std::move(error);
 	}
+	m_children.clear();
+	m_children.shrink_to_fit();
 	return std::nullopt;
 }
 
-void Namespace::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Namespace::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	const bool global = (GetName().empty() == true);
+	TraceScope printScope("print", (global == true) ? "global namespace" : GetName());
 	if (global == false)
 	{
 		PrintIndents(outFile, indentLevel);
@@ -387,21 +729,11 @@ void Namespace::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
 		PrintIndents(outFile, indentLevel);
 		outFile << "{\n";
 	}
-	for (const auto& namedPair : m_namedConcepts)
+	for (const auto& namedPair : GetSortedConcepts())
 	{
-		const auto namedConcept = namedPair.second.lock();
-		if (namedConcept->GetType() != Type::Namespace)
-		{
-			if (namedConcept->GetType() == Type::Typed)
-			{
-				// make sure it is a class type
-				if (std::static_pointer_cast<Typed>(namedConcept)->GetTypeCode() !=
-					Typed::TypeCode::Class)
-					continue;
-			}
-			else
-				continue;
-		}
+		const auto namedConcept = namedPair.second;
+		if (IsPrinted(*namedConcept) == false)
+			continue;
 		namedConcept->PrintToFile(outFile, indentLevel + 1 - global);
 	}
 	if (global == false)
@@ -411,10 +743,45 @@ void Namespace::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
 	}
 }
 
+void Namespace::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.Write(m_namedConcepts.size());
+	// the key is stored since the concept may be read after us. sorted
+	// so the same concepts make the same cache
+	for (const auto& [name, named] : GetSortedConcepts())
+	{
+		writer.WriteString(name);
+		writer.WriteReference(named);
+	}
+}
+
+std::optional<std::string> Namespace::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	const auto conceptCount = reader.ReadCount();
+	for (uint64_t i = 0; i < conceptCount; ++i)
+	{
+		const auto name = reader.ReadString();
+		m_namedConcepts.emplace(name, reader.ReadReference<Named>());
+	}
+	return reader.Error();
+}
+
+bool Namespace::IsPrinted(const Named& named) noexcept
+{
+	if (named.GetType() == Type::Namespace)
+		return true;
+	// make sure it is a class type
+	return (named.GetType() == Type::Typed &&
+		static_cast<const Typed&>(named).GetTypeCode() == Typed::TypeCode::Class);
+}
+
 std::optional<std::string> Pointer::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto type = die.resolve(dwarf::DW_AT::type);
+	const Attributes attributes(die);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == true)
 	{
 		auto parsedType = parser.ParseDIE(type.as_reference());
@@ -422,21 +789,40 @@ std::optional<std::string> Pointer::ParseDIE(Parser& parser,
 			return std::move(parsedType.error());
 		if (parsedType.value()->GetType() != Type::Typed)
 			return "A pointer was not in reference to a type!";
-		m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+		m_type = static_cast<Typed*>(parsedType.value());
 	}
-	SetName((m_type.has_value() == true ? m_type->lock()->GetName() : "void") + '*');
 	return std::nullopt;
 }
 
-void Pointer::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+std::optional<std::string> Pointer::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern(std::string(m_type != nullptr ? m_type->GetName() : "void") + '*'));
+	return std::nullopt;
+}
+
+void Pointer::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void Pointer::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> Pointer::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Named>();
+	return reader.Error();
 }
 
 std::optional<std::string> PointerToMember::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto containingType = die.resolve(dwarf::DW_AT::containing_type);
+	const Attributes attributes(die);
+	auto containingType = attributes.Resolve(dwarf::DW_AT::containing_type);
 	if (containingType.valid() == false)
 		return "A pointer-to-member was missing a containing type!";
 	auto parsedContainingNamed = parser.ParseDIE(containingType.as_reference());
@@ -444,12 +830,11 @@ std::optional<std::string> PointerToMember::ParseDIE(Parser& parser,
 		return std::move(parsedContainingNamed.error());
 	if (parsedContainingNamed.value()->GetType() != Type::Typed)
 		return "A pointer-to-member had a non-typed containing type!";
-	auto parsedContainingType = std::static_pointer_cast<Typed>(
-		std::move(parsedContainingNamed.value()));
+	auto parsedContainingType = static_cast<Typed*>(parsedContainingNamed.value());
 	if (parsedContainingType->GetTypeCode() != TypeCode::Class)
 		return "A pointer-to-member's containing type was not class-based!";
-	m_containingType = std::static_pointer_cast<Class>(std::move(parsedContainingType));
-	auto functionType = die.resolve(dwarf::DW_AT::type);
+	m_containingType = static_cast<Class*>(parsedContainingType);
+	auto functionType = attributes.Resolve(dwarf::DW_AT::type);
 	if (functionType.valid() == false)
 		return "A pointer-to-member was missing a function type!";
 	auto parsedFunctionNamed = parser.ParseDIE(functionType.as_reference());
@@ -457,25 +842,40 @@ std::optional<std::string> PointerToMember::ParseDIE(Parser& parser,
 		return std::move(parsedFunctionNamed.error());
 	if (parsedFunctionNamed.value()->GetType() != Type::Typed)
 		return "A pointer-to-member had a non-type function!";
-	auto parsedFunctionType = std::static_pointer_cast<Typed>(
-		std::move(parsedFunctionNamed.value()));
+	auto parsedFunctionType = static_cast<Typed*>(parsedFunctionNamed.value());
 	if (parsedFunctionType->GetTypeCode() != TypeCode::Subroutine)
 		return "A pointer-to-member had a non-subroutine function!";
-	m_functionType = std::static_pointer_cast<Subroutine>(std::move(parsedFunctionType));
+	m_functionType = static_cast<Subroutine*>(parsedFunctionType);
 	// todo: construct a pointer-to-member type
 	return std::nullopt;
 }
 
-void PointerToMember::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void PointerToMember::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void PointerToMember::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_containingType);
+	writer.WriteReference(m_functionType);
+}
 
+std::optional<std::string> PointerToMember::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_containingType = reader.ReadReference<Class>();
+	m_functionType = reader.ReadReference<Subroutine>();
+	return reader.Error();
 }
 
 std::optional<std::string> RefType::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
+	const Attributes attributes(die);
 	// parse the embedded type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A ref type did not have a type!";
 	auto parsedType = parser.ParseDIE(type.as_reference());
@@ -483,21 +883,40 @@ std::optional<std::string> RefType::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A ref type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
-	SetName(m_type.lock()->GetName() + '&');
+	m_type = static_cast<Typed*>(parsedType.value());
+	return std::nullopt;
+}
+
+std::optional<std::string> RefType::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern(std::string(m_type->GetName()) + '&'));
 	return std::nullopt;
 }
 
-void RefType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void RefType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void RefType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> RefType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Named>();
+	return reader.Error();
 }
 
 std::optional<std::string> RRefType::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
+	const Attributes attributes(die);
 	// parse the embedded type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A rref type did not have a type!";
 	auto parsedType = parser.ParseDIE(type.as_reference());
@@ -505,21 +924,40 @@ std::optional<std::string> RRefType::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A rref type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
-	SetName(m_type.lock()->GetName() + "&&");
+	m_type = static_cast<Typed*>(parsedType.value());
+	return std::nullopt;
+}
+
+std::optional<std::string> RRefType::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern(std::string(m_type->GetName()) + "&&"));
 	return std::nullopt;
 }
 
-void RRefType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void RRefType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void RRefType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> RRefType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Named>();
+	return reader.Error();
 }
 
 std::optional<std::string> SubProgram::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
 	// see if this is a specification
-	auto spec = die.resolve(dwarf::DW_AT::specification);
+	const Attributes attributes(die);
+	auto spec = attributes.Resolve(dwarf::DW_AT::specification);
 	if (spec.valid() == true)
 	{
 		// this is a specification. find the existing function and add params
@@ -528,9 +966,8 @@ std::optional<std::string> SubProgram::ParseDIE(Parser& parser,
 			return std::move(existingNamed.error());
 		if (existingNamed.value()->GetType() != Type::SubProgram)
 			return "A subprogram specification was not a subprogram!";
-		auto existingFn = std::static_pointer_cast<SubProgram>(std::move(existingNamed.value()));
-		// erase existing parameters and rewrite them
-		existingFn->m_parameters.clear();
+		m_specified = static_cast<SubProgram*>(existingNamed.value());
+		// the existing parameters are replaced with these once finalized
 		for (const auto param : die)
 		{
 			if (param.tag != dwarf::DW_TAG::formal_parameter)
@@ -540,20 +977,17 @@ std::optional<std::string> SubProgram::ParseDIE(Parser& parser,
 				return std::move(parsedParam.error());
 			if (parsedParam.value()->GetType() != Type::Value)
 				return "A subprogram's parameter was a non value-type";
-			existingFn->m_parameters.push_back(std::static_pointer_cast<Value>(
-				std::move(parsedParam.value())));
+			m_parameters.push_back(static_cast<Value*>(parsedParam.value()));
 		}
-		// leave ourselves empty
 		return std::nullopt;
 	}
-	auto name = die.resolve(dwarf::DW_AT::name);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == false)
 		return "A subprogram was missing a name!";
-	SetName(name.as_string());
+	SetName(parser.Intern(name.as_cstr()));
 	// get the return type. it's under type. if type
 	// doesn't exist, return type is void
-	std::optional<std::shared_ptr<Typed>> returnType;
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == true)
 	{
 		// parse the return type
@@ -562,10 +996,10 @@ std::optional<std::string> SubProgram::ParseDIE(Parser& parser,
 			return std::move(parsedType.error());
 		if (parsedType.value()->GetType() != Type::Typed)
 			return "A subprogram has a non-type return type!";
-		m_returnType = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+		m_returnType = static_cast<Typed*>(parsedType.value());
 	}
 	// see if we are virtual
-	auto virtuality = die.resolve(dwarf::DW_AT::virtuality);
+	auto virtuality = attributes.Resolve(dwarf::DW_AT::virtuality);
 	if (virtuality.valid() == true && virtuality.as_uconstant() == 1)
 		m_virtual = true;
 	// loop through the parameters, which are the sibling's children
@@ -573,26 +1007,37 @@ std::optional<std::string> SubProgram::ParseDIE(Parser& parser,
 	{
 		if (param.tag != dwarf::DW_TAG::formal_parameter)
 			continue;
-		auto artificial = param.resolve(dwarf::DW_AT::artificial);
 		auto parsedParam = parser.ParseDIE(param);
 		if (parsedParam.has_value() == false)
 			return std::move(parsedParam.error());
 		if (parsedParam.value()->GetType() != Type::Value)
 			return "A subprogram's parameter was a non value-type";
-		m_parameters.push_back(std::static_pointer_cast<Value>(
-			std::move(parsedParam.value())));
+		m_parameters.push_back(static_cast<Value*>(parsedParam.value()));
 	}
 	return std::nullopt;
 }
 
-void SubProgram::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+std::optional<std::string> SubProgram::Finalize(Parser& parser) noexcept
+{
+	if (m_specified == nullptr)
+		return std::nullopt;
+	// other threads may be specifying the same function
+	std::scoped_lock lock(parser.m_parseMutex);
+	m_specified->m_parameters = std::move(m_parameters);
+	// leave ourselves empty
+	m_parameters.clear();
+	m_specified = nullptr;
+	return std::nullopt;
+}
+
+void SubProgram::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	PrintIndents(outFile, indentLevel);
 	// if we are virtual, print that
 	if (m_virtual == true)
 		outFile << "virtual ";
-	if (m_returnType.has_value() == true)
-		outFile << m_returnType->lock()->GetName();
+	if (m_returnType != nullptr)
+		outFile << m_returnType->GetName();
 	else
 		outFile << "void";
 	outFile << ' ' << GetName() << '(';
@@ -600,18 +1045,40 @@ void SubProgram::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcep
 	{
 		if (paramIt != m_parameters.begin())
 			outFile << ", ";
-		auto param = paramIt->lock();
-		outFile << param->GetValueType().lock()->GetName();
+		auto param = *paramIt;
+		outFile << param->GetValueType()->GetName();
 		if (param->GetName().empty() == false)
 			outFile << ' ' << param->GetName();
 	}
 	outFile << ");\n";
 }
 
+void SubProgram::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.Write(m_virtual);
+	writer.WriteReference(m_returnType);
+	writer.Write(m_parameters.size());
+	for (const auto parameter : m_parameters)
+		writer.WriteReference(parameter);
+}
+
+std::optional<std::string> SubProgram::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_virtual = (reader.Read() != 0);
+	m_returnType = reader.ReadReference<Typed>();
+	const auto parameterCount = reader.ReadCount();
+	for (uint64_t i = 0; i < parameterCount; ++i)
+		m_parameters.push_back(reader.ReadReference<Value>());
+	return reader.Error();
+}
+
 std::optional<std::string> Subroutine::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto returnType = die.resolve(dwarf::DW_AT::type);
+	const Attributes attributes(die);
+	auto returnType = attributes.Resolve(dwarf::DW_AT::type);
 	if (returnType.valid() == true)
 	{
 		// parse the type
@@ -620,45 +1087,72 @@ std::optional<std::string> Subroutine::ParseDIE(Parser& parser,
 			return std::move(parsedType.error());
 		if (parsedType.value()->GetType() != Type::Typed)
 			return "A subroutine's return type was not a type!";
-		m_returnType = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+		m_returnType = static_cast<Typed*>(parsedType.value());
 	}
-	std::string name = "FunctionPtr<" + ((m_returnType.has_value() == true) ?
-		m_returnType->lock()->GetName() : "void");
-	name += '(';
 	// parse each parameter
-	for (auto paramIt = die.begin(); paramIt != die.end(); ++paramIt)
+	for (const auto param : die)
 	{
-		if (paramIt->tag != dwarf::DW_TAG::formal_parameter)
+		if (param.tag != dwarf::DW_TAG::formal_parameter)
 			continue;
-		if (paramIt != die.begin())
-			name += ", ";
-		auto parsedParam = parser.ParseDIE(*paramIt);
+		auto parsedParam = parser.ParseDIE(param);
 		if (parsedParam.has_value() == false)
 			return std::move(parsedParam.error());
 		if (parsedParam.value()->GetType() != Type::Value)
 			return "A subroutine had a non-value parameter";
-		m_parameters.emplace_back(std::static_pointer_cast<Value>(
-			std::move(parsedParam.value())));
+		m_parameters.emplace_back(static_cast<Value*>(parsedParam.value()));
+	}
+	return std::nullopt;
+}
+
+std::optional<std::string> Subroutine::Finalize(Parser& parser) noexcept
+{
+	std::string name = "FunctionPtr<" + std::string((m_returnType != nullptr) ?
+		m_returnType->GetName() : "void");
+	name += '(';
+	for (auto paramIt = m_parameters.begin(); paramIt != m_parameters.end(); ++paramIt)
+	{
+		if (paramIt != m_parameters.begin())
+			name += ", ";
 	}
 	name += ")>";
-	SetName(std::move(name));
+	SetName(parser.Intern(name));
 	return std::nullopt;
 }
 
-void Subroutine::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Subroutine::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void Subroutine::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_returnType);
+	writer.Write(m_parameters.size());
+	for (const auto parameter : m_parameters)
+		writer.WriteReference(parameter);
+}
 
+std::optional<std::string> Subroutine::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_returnType = reader.ReadReference<Typed>();
+	const auto parameterCount = reader.ReadCount();
+	for (uint64_t i = 0; i < parameterCount; ++i)
+		m_parameters.push_back(reader.ReadReference<Value>());
+	return reader.Error();
 }
 
 std::optional<std::string> TypeDef::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == false)
 		return "A typedef was missing a name!";
-	SetName(name.as_string());
+	SetName(parser.Intern(name.as_cstr()));
 	// find the type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A typedef was missing a type!";
 	// parse the type
@@ -667,20 +1161,34 @@ std::optional<std::string> TypeDef::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A typedef's type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+	m_type = static_cast<Typed*>(parsedType.value());
 	return std::nullopt;
 }
 
-void TypeDef::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void TypeDef::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	PrintIndents(outFile, indentLevel);
-	outFile << "typedef " << m_type.lock()->GetName() << ' ' << GetName() << ";\n";
+	outFile << "typedef " << m_type->GetName() << ' ' << GetName() << ";\n";
+}
+
+void TypeDef::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
+
+std::optional<std::string> TypeDef::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Typed>();
+	return reader.Error();
 }
 
 std::optional<std::string> Value::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
-	auto name = die.resolve(dwarf::DW_AT::name);
+	const Attributes attributes(die);
+	auto name = attributes.Resolve(dwarf::DW_AT::name);
 	if (name.valid() == false)
 	{
 		// this is used for template and function params too,
@@ -689,9 +1197,9 @@ std::optional<std::string> Value::ParseDIE(Parser& parser,
 			return "A value was missing a name!";
 	}
 	else
-		SetName(name.as_string());
+		SetName(parser.Intern(name.as_cstr()));
 	// find the type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A value was missing a type!";
 	// parse the type
@@ -700,21 +1208,35 @@ std::optional<std::string> Value::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A value's type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
+	m_type = static_cast<Typed*>(parsedType.value());
 	return std::nullopt;
 }
 
-void Value::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void Value::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
 {
 	PrintIndents(outFile, indentLevel);
-	outFile << m_type.lock()->GetName() << ' ' << GetName() << ";\n";
+	outFile << m_type->GetName() << ' ' << GetName() << ";\n";
+}
+
+void Value::Serialize(CacheWriter& writer) const noexcept
+{
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
+
+std::optional<std::string> Value::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Typed>();
+	return reader.Error();
 }
 
 std::optional<std::string> VolatileType::ParseDIE(Parser& parser,
 	const dwarf::die& die) noexcept
 {
+	const Attributes attributes(die);
 	// parse the embedded type
-	auto type = die.resolve(dwarf::DW_AT::type);
+	auto type = attributes.Resolve(dwarf::DW_AT::type);
 	if (type.valid() == false)
 		return "A volatile type did not have a type!";
 	auto parsedType = parser.ParseDIE(type.as_reference());
@@ -722,139 +1244,1801 @@ std::optional<std::string> VolatileType::ParseDIE(Parser& parser,
 		return std::move(parsedType.error());
 	if (parsedType.value()->GetType() != Type::Typed)
 		return "A volatile type was not a type!";
-	m_type = std::static_pointer_cast<Typed>(std::move(parsedType.value()));
-	SetName(m_type.lock()->GetName() + '&');
+	m_type = static_cast<Typed*>(parsedType.value());
+	return std::nullopt;
+}
+
+std::optional<std::string> VolatileType::Finalize(Parser& parser) noexcept
+{
+	SetName(parser.Intern(std::string(m_type->GetName()) + '&'));
 	return std::nullopt;
 }
 
-void VolatileType::PrintToFile(std::ofstream& outFile, size_t indentLevel) noexcept
+void VolatileType::PrintToFile(std::ostream& outFile, size_t indentLevel) noexcept
+{
+
+}
+
+void VolatileType::Serialize(CacheWriter& writer) const noexcept
 {
+	writer.WriteString(GetInternedName());
+	writer.WriteReference(m_type);
+}
 
+std::optional<std::string> VolatileType::Deserialize(CacheReader& reader) noexcept
+{
+	SetName(reader.ReadString());
+	m_type = reader.ReadReference<Named>();
+	return reader.Error();
 }
 
 // parser
 
+thread_local Parser::Traversal* Parser::s_traversal = nullptr;
+
+InternedString Parser::Intern(std::string_view str) noexcept
+{
+	return GetStringPool().Intern(str);
+}
+
+StringPool& Parser::GetStringPool() noexcept
+{
+	auto& owner = (m_owner != nullptr) ? *m_owner : *this;
+	return (owner.m_typeStore != nullptr) ? owner.m_typeStore->m_strings : owner.m_strings;
+}
+
 void Parser::AddParent(const Named& child, const Named& parent) noexcept
 {
+	std::scoped_lock lock(m_parseMutex);
 	m_childToParentMap.emplace(&child, &parent);
 }
 
+std::stack<const Named*> Parser::PathToGlobal(const Named& named) noexcept
+{
+	// the concept is at the bottom, and its outermost parent at the top
+	std::stack<const Named*> path;
+	path.push(&named);
+	for (auto parentIt = m_childToParentMap.find(&named); parentIt != m_childToParentMap.end();
+		parentIt = m_childToParentMap.find(parentIt->second))
+		path.push(parentIt->second);
+	return path;
+}
+
+std::optional<std::string> Parser::StreamDWARF(const dwarf::dwarf& data, std::ostream& outFile) noexcept
+{
+	m_stream = &outFile;
+	auto result = ParseDWARF(data);
+	m_stream = nullptr;
+	return result;
+}
+
 std::optional<std::string> Parser::ParseDWARF(const dwarf::dwarf& data) noexcept
 {
-	size_t unitNo = 1;
-	for (const auto& compilationUnit : data.compilation_units())
+	const auto& units = data.compilation_units();
+	auto selectedUnits = SelectUnits(units);
+	std::unordered_set<const dwarf::compilation_unit*> parsedUnits(selectedUnits.begin(),
+		selectedUnits.end());
+	std::unordered_set<std::string> lookedUp;
+	// then parse the units that define what those only declared, until
+	// there are none left
+	do
 	{
-		size_t startingTypes = m_parsedEntries.size();
-		if (auto res = ParseCompilationUnit(compilationUnit); 
-			res.has_value() == true)
-			return std::move(res.value());
-		size_t currentTypes = m_parsedEntries.size();
-		size_t deltaTypes = currentTypes - startingTypes;
-		printf("Parsed unit %zd/%zd with %zd new types and %zd total\n",
-			unitNo++, data.compilation_units().size(), deltaTypes, m_parsedEntries.size());
-	}
+		if (auto error = ParseUnits(data, std::move(selectedUnits)); error.has_value() == true)
+			return error;
+		selectedUnits = SelectDefiningUnits(units, parsedUnits, lookedUp);
+	} while (selectedUnits.empty() == false);
 	return std::nullopt;
 }
 
-std::optional<std::string> Parser::ParseCompilationUnit(const dwarf::compilation_unit& unit) noexcept
+std::optional<std::string> Parser::ParseUnits(const dwarf::dwarf& data,
+	std::vector<const dwarf::compilation_unit*> selectedUnits) noexcept
 {
-	for (const auto& die : unit.root())
+	TraceScope loadScope("load", "Load units");
+	const auto& units = data.compilation_units();
+	m_typeUnitParser.reset(new Parser(*this));
+	// units are contiguous, and the last one ends with the section
+	std::vector<size_t> unitBytes;
+	unitBytes.reserve(selectedUnits.size());
+	for (const auto unit : selectedUnits)
 	{
-		if (auto res = ParseDIE(die); res.has_value() == false)
-			return std::move(res.error());
-		else if (auto error = m_globalNamespace.AddNamed(*this, std::move(res.value()));
-			error.has_value() == true)
+		const size_t unitIndex = unit - units.data();
+		const auto offset = unit->get_section_offset();
+		if (unitIndex + 1 < units.size())
+			unitBytes.push_back(units[unitIndex + 1].get_section_offset() - offset);
+		else
+			unitBytes.push_back((m_infoSize > offset) ? m_infoSize - offset : 0);
+	}
+	// skeleton units stand for their split units. those aren't in the
+	// file, so they aren't cached
+	std::vector<bool> splitUnits(selectedUnits.size(), false);
+	m_skeletonOffsets.clear();
+	m_unitHashes.clear();
+	for (size_t unitIndex = 0; m_splitUnits != nullptr && unitIndex < selectedUnits.size(); ++unitIndex)
+	{
+		if (const auto splitUnit = m_splitUnits->Find(*selectedUnits[unitIndex]);
+			splitUnit != nullptr)
+		{
+			m_skeletonOffsets.emplace(splitUnit->unit, selectedUnits[unitIndex]->get_section_offset());
+			selectedUnits[unitIndex] = splitUnit->unit;
+			unitBytes[unitIndex] = splitUnit->bytes;
+			splitUnits[unitIndex] = true;
+		}
+	}
+	// libelfin lazily loads sections and abbreviations without any
+	// synchronization, so make sure they are loaded before sharing
+	// the data between threads
+	try
+	{
+		data.get_section(dwarf::section_type::str);
+	}
+	catch (const std::exception&)
+	{
+		// not every file has a string section
+	}
+	for (const auto compilationUnit : selectedUnits)
+		compilationUnit->root();
+	LoadTypeUnits(data);
+	loadScope.End();
+	if (m_memoryBudget != 0)
+		return ParseInWindows(selectedUnits, unitBytes, splitUnits);
+	// each unit is parsed by its own parser so units can be parsed in
+	// parallel, then merged in order so the result does not depend on
+	// the number of threads. the top-level DIEs of a unit are split
+	// into tasks as well, so one huge unit still uses every thread
+	TaskPool pool(m_threadCount);
+	std::vector<std::unique_ptr<Parser>> unitParsers;
+	unitParsers.reserve(selectedUnits.size());
+	for (size_t unitIndex = 0; unitIndex < selectedUnits.size(); ++unitIndex)
+	{
+		auto unitParser = unitParsers.emplace_back(new Parser(*this)).get();
+		PushCompilationUnit(pool, *unitParser, *selectedUnits[unitIndex],
+			unitBytes[unitIndex], splitUnits[unitIndex] == false);
+	}
+	// when streaming, units are printed in order while the rest are
+	// still being parsed
+	if (m_stream != nullptr)
+	{
+		std::thread poolThread;
+		try
+		{
+			poolThread = std::thread(&TaskPool::Run, &pool);
+		}
+		catch (const std::system_error&)
+		{
+			// parse everything first instead
+			pool.Run();
+		}
+		std::optional<std::string> result;
+		for (size_t unitIndex = 0; unitIndex < selectedUnits.size(); ++unitIndex)
+		{
+			const auto& unit = *selectedUnits[unitIndex];
+			auto& unitParser = *unitParsers[unitIndex];
+			WaitForUnit(unitParser);
+			result = FinishCompilationUnit(unitParser, unit, unitBytes[unitIndex]);
+			if (result.has_value() == true)
+			{
+				// stop the remaining units early
+				m_failed = true;
+				break;
+			}
+			unitParsers[unitIndex].reset();
+		}
+		if (poolThread.joinable() == true)
+			poolThread.join();
+		// the types were printed with the units that reference them
+		MergeTypeUnits();
+		return result;
+	}
+	pool.Run();
+	// every traversal is done, so names lent across cycles can be derived
+	for (const auto& unitParser : unitParsers)
+	{
+		pool.Push([unitParser = unitParser.get()]()
+			{
+				unitParser->DeriveCycleNames();
+			});
+	}
+	pool.Run();
+	// cache the units that were parsed for the next run
+	if (m_unitCacheFile != nullptr && m_failed == false)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_unitCacheDirectory, error);
+		for (const auto& unitParser : unitParsers)
+		{
+			if (unitParser->m_unitCached == true || unitParser->m_unitKey.empty() == true)
+				continue;
+			pool.Push([unitParser = unitParser.get()]()
+				{
+					unitParser->m_unitCacheError = unitParser->SaveCompilationUnit();
+				});
+		}
+		pool.Run();
+		// a missing cache only costs time on the next run
+		for (const auto& unitParser : unitParsers)
+		{
+			if (unitParser->m_unitCacheError.has_value() == true && m_unitCacheError.has_value() == false)
+				m_unitCacheError = std::move(unitParser->m_unitCacheError);
+		}
+	}
+	// every unit is alive until it is merged
+	size_t nodeBytes = m_arena.BytesReserved();
+	for (const auto& unitParser : unitParsers)
+		nodeBytes += unitParser->m_arena.BytesReserved();
+	m_statistics.peakNodeBytes = std::max(m_statistics.peakNodeBytes, nodeBytes);
+	for (size_t unitIndex = 0; unitIndex < selectedUnits.size(); ++unitIndex)
+	{
+		const auto& unit = *selectedUnits[unitIndex];
+		RecordUnit(*unitParsers[unitIndex], unit, unitBytes[unitIndex]);
+		TraceScope mergeScope("merge", "MergeCompilationUnit",
+			{ { "offset", unit.get_section_offset() } });
+		const auto mergeStart = std::chrono::steady_clock::now();
+		auto res = MergeCompilationUnit(*unitParsers[unitIndex]);
+		AddMergeTime(mergeStart);
+		if (res.has_value() == true)
+			return std::move(res.value());
+		unitParsers[unitIndex].reset();
+	}
+	MergeTypeUnits();
+	return std::nullopt;
+}
+
+std::optional<std::string> Parser::ParseInWindows(
+	const std::vector<const dwarf::compilation_unit*>& units,
+	const std::vector<size_t>& unitBytes, const std::vector<bool>& splitUnits) noexcept
+{
+	// parse a window of units at a time, and free each window before
+	// the next starts. the window grows while memory is to spare, and
+	// shrinks down to one unit once it is not
+	TaskPool pool(m_threadCount);
+	size_t windowSize = pool.ThreadCount();
+	for (size_t windowBegin = 0; windowBegin < units.size();)
+	{
+		const size_t windowEnd = std::min(windowBegin + windowSize, units.size());
+		std::vector<std::unique_ptr<Parser>> unitParsers;
+		unitParsers.reserve(windowEnd - windowBegin);
+		for (size_t unitIndex = windowBegin; unitIndex < windowEnd; ++unitIndex)
+		{
+			auto unitParser = unitParsers.emplace_back(new Parser(*this)).get();
+			PushCompilationUnit(pool, *unitParser, *units[unitIndex],
+				unitBytes[unitIndex], splitUnits[unitIndex] == false);
+		}
+		const size_t residentBytes = RunWindow(pool);
+		m_statistics.peakResidentBytes = std::max(m_statistics.peakResidentBytes, residentBytes);
+		for (size_t unitIndex = windowBegin; unitIndex < windowEnd; ++unitIndex)
+		{
+			auto& unitParser = unitParsers[unitIndex - windowBegin];
+			if (auto error = FinishCompilationUnit(*unitParser, *units[unitIndex],
+				unitBytes[unitIndex]); error.has_value() == true)
+				return error;
+			unitParser.reset();
+		}
+		// without a way to measure, keep one unit per thread
+		if (residentBytes > m_memoryBudget)
+			windowSize = std::max<size_t>(windowSize / 2, 1);
+		else if (residentBytes != 0 && residentBytes < m_memoryBudget / 2)
+			windowSize *= 2;
+		windowBegin = windowEnd;
+	}
+	MergeTypeUnits();
+	return std::nullopt;
+}
+
+void Parser::PushCompilationUnit(TaskPool& pool, Parser& unitParser,
+	const dwarf::compilation_unit& unit, size_t bytes, bool cacheable) noexcept
+{
+	pool.Push([&unitParser, &unit, bytes, cacheable, &pool]()
+		{
+			// a DIE is rarely smaller than 32 bytes with its children,
+			// so this is enough for most units to never rehash the memo
+			unitParser.m_parsedEntries.Reserve(bytes / 32);
+			TraceScope unitScope("unit", "ParseCompilationUnit",
+				{ { "offset", unit.get_section_offset() } });
+			const auto start = std::chrono::steady_clock::now();
+			// units that have not changed since they were cached
+			// are loaded instead
+			if (cacheable == false || unitParser.LoadCompilationUnit(unit) == false)
+				unitParser.ParseCompilationUnit(unit, pool);
+			unitParser.AddParseTime(start);
+			unitParser.FinishTask();
+		});
+}
+
+std::optional<std::string> Parser::FinishCompilationUnit(Parser& unitParser,
+	const dwarf::compilation_unit& unit, size_t bytes) noexcept
+{
+	unitParser.DeriveCycleNames();
+	if (m_unitCacheFile != nullptr && unitParser.m_unitCached == false &&
+		unitParser.m_unitKey.empty() == false && m_failed == false)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_unitCacheDirectory, error);
+		// a missing cache only costs time on the next run
+		if (auto cacheError = unitParser.SaveCompilationUnit();
+			cacheError.has_value() == true && m_unitCacheError.has_value() == false)
+			m_unitCacheError = std::move(cacheError);
+	}
+	m_statistics.peakNodeBytes = std::max(m_statistics.peakNodeBytes,
+		m_arena.BytesReserved() + unitParser.m_arena.BytesReserved());
+	RecordUnit(unitParser, unit, bytes);
+	if (m_stream == nullptr)
+	{
+		TraceScope mergeScope("merge", "MergeCompilationUnit",
+			{ { "offset", unit.get_section_offset() } });
+		const auto mergeStart = std::chrono::steady_clock::now();
+		auto res = MergeCompilationUnit(unitParser);
+		AddMergeTime(mergeStart);
+		return res;
+	}
+	TraceScope streamScope("merge", "StreamCompilationUnit",
+		{ { "offset", unit.get_section_offset() } });
+	return StreamCompilationUnit(unitParser);
+}
+
+size_t Parser::RunWindow(TaskPool& pool) noexcept
+{
+	// the resident set peaks while the window parses, before any of
+	// it is freed, so it is sampled until the pool is done
+	std::mutex sampleMutex;
+	std::condition_variable sampleCondition;
+	bool done = false;
+	size_t peakBytes = 0;
+	std::thread sampler;
+	try
+	{
+		sampler = std::thread([&sampleMutex, &sampleCondition, &done, &peakBytes]()
+			{
+				std::unique_lock lock(sampleMutex);
+				while (done == false)
+				{
+					peakBytes = std::max(peakBytes, GetResidentBytes());
+					sampleCondition.wait_for(lock, std::chrono::milliseconds(10));
+				}
+			});
+	}
+	catch (const std::system_error&)
+	{
+		// only measure once the window is parsed instead
+	}
+	pool.Run();
+	{
+		std::scoped_lock lock(sampleMutex);
+		done = true;
+	}
+	sampleCondition.notify_one();
+	if (sampler.joinable() == true)
+		sampler.join();
+	return std::max(peakBytes, GetResidentBytes());
+}
+
+size_t Parser::GetResidentBytes() noexcept
+{
+#ifdef __linux__
+	// only anonymous memory counts. the mapped ELF file is resident too
+	// once its sections are read, but the kernel can drop it at any time
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.starts_with("RssAnon:") == false)
+			continue;
+		size_t kilobytes = 0;
+		const auto digits = line.find_first_of("0123456789");
+		if (digits == std::string::npos || std::from_chars(line.data() + digits,
+			line.data() + line.size(), kilobytes).ec != std::errc())
+			return 0;
+		return kilobytes * 1024;
+	}
+	return 0;
+#else
+	return 0;
+#endif
+}
+
+void Parser::LoadTypeUnits(const dwarf::dwarf& data) const noexcept
+{
+	// the table of type units is read the first time any signature is
+	// looked up, whether or not the file has it
+	try
+	{
+		data.get_type_unit(0);
+	}
+	catch (const std::exception&)
+	{
+		// no type unit has that signature, or there are none
+	}
+	// each type unit's root and abbreviations are read the first time its
+	// type is. libelfin can't list the type units, so their signatures
+	// are read from the headers in .debug_types
+	if (m_file == nullptr)
+		return;
+	const auto& types = m_file->get_section(".debug_types");
+	if (types.valid() == false || SectionLoader::IsCompressed(types) == true)
+		return;
+	const auto typesData = static_cast<const uint8_t*>(types.data());
+	for (size_t unitOffset = 0; unitOffset + 4 <= types.size();)
+	{
+		// the length, which is 64-bit if the 32-bit length is all ones,
+		// the version, the abbreviation offset, the address size and the
+		// signature
+		uint64_t unitLength = 0;
+		size_t offsetSize = 4;
+		std::memcpy(&unitLength, typesData + unitOffset, 4);
+		if (unitLength == 0xffffffff)
+		{
+			if (unitOffset + 12 > types.size())
+				return;
+			std::memcpy(&unitLength, typesData + unitOffset + 4, 8);
+			offsetSize = 8;
+		}
+		const size_t headerOffset = unitOffset + ((offsetSize == 8) ? 12 : 4);
+		const size_t signatureOffset = headerOffset + 2 + offsetSize + 1;
+		if (unitLength > types.size() - headerOffset || signatureOffset + 8 > headerOffset + unitLength)
+			return;
+		uint64_t signature;
+		std::memcpy(&signature, typesData + signatureOffset, sizeof(signature));
+		try
+		{
+			const auto& typeUnit = data.get_type_unit(signature);
+			typeUnit.root();
+			typeUnit.type();
+		}
+		catch (const std::exception&)
+		{
+			// a unit that can't be read fails when it is referenced instead
+		}
+		unitOffset = headerOffset + unitLength;
+	}
+}
+
+std::optional<dwarf::die> Parser::ResolveSignature(const dwarf::die& die) noexcept
+{
+	if (die.has(dwarf::DW_AT::signature) == false)
+		return std::nullopt;
+	// type units that weren't loaded up front, because the parser has no
+	// file or .debug_types is compressed, are loaded here, which must
+	// only happen on one thread at a time
+	static std::mutex loadMutex;
+	try
+	{
+		const auto value = die[dwarf::DW_AT::signature];
+		if (value.get_type() != dwarf::value::type::reference)
+			return std::nullopt;
+		std::scoped_lock lock(loadMutex);
+		return value.as_reference();
+	}
+	catch (const std::exception&)
+	{
+		// the type unit is missing, so the declaration is all there is
+		return std::nullopt;
+	}
+}
+
+std::string Parser::GetAnonymousName(const dwarf::die& die) noexcept
+{
+	// split units and type units have sections of their own, so their
+	// offsets are only unique along with the skeleton or signature
+	auto& owner = (m_owner != nullptr) ? *m_owner : *this;
+	const auto& unit = die.get_unit();
+	const auto unitOffset = std::to_string(die.get_section_offset() - unit.get_section_offset());
+	std::string name = "__anonymous_";
+	// cached units must not depend on where other units are, so types
+	// are named by their offset in their unit, along with the signature
+	// of a type unit or the hash of any other unit
+	if (const auto typeUnit = dynamic_cast<const dwarf::type_unit*>(&unit); typeUnit != nullptr)
+		return name.append(std::to_string(typeUnit->get_type_signature())).append("_").append(unitOffset);
+	if (const auto skeletonIt = owner.m_skeletonOffsets.find(&unit);
+		skeletonIt != owner.m_skeletonOffsets.end())
+		return name.append(std::to_string(skeletonIt->second)).append("_")
+			.append(std::to_string(die.get_section_offset()));
+	{
+		std::scoped_lock lock(owner.m_unitHashMutex);
+		if (const auto hashIt = owner.m_unitHashes.find(&unit); hashIt != owner.m_unitHashes.end())
+			return name.append(hashIt->second).append("_").append(unitOffset);
+	}
+	// hash the unit outside of the lock, since it may be large. without
+	// the raw unit, fall back to its offset in the section
+	std::optional<std::string> hash;
+	if (owner.m_file != nullptr)
+		hash = GetUnitHash(*owner.m_file, unit.get_section_offset());
+	if (hash.has_value() == false)
+		hash = std::to_string(unit.get_section_offset());
+	std::scoped_lock lock(owner.m_unitHashMutex);
+	const auto hashIt = owner.m_unitHashes.emplace(&unit, std::move(hash.value())).first;
+	return name.append(hashIt->second).append("_").append(unitOffset);
+}
+
+bool Parser::InTypeUnit(const dwarf::die& die) noexcept
+{
+	return dynamic_cast<const dwarf::type_unit*>(&die.get_unit()) != nullptr;
+}
+
+void Parser::MergeTypeUnits() noexcept
+{
+	if (m_typeUnitParser == nullptr)
+		return;
+	// the types are already in the namespaces of the units that
+	// reference them, so only take ownership
+	auto& typeUnitParser = *m_typeUnitParser;
+	typeUnitParser.DeriveCycleNames();
+	m_statistics.Merge(typeUnitParser.m_statistics);
+	m_arena.Adopt(std::move(typeUnitParser.m_arena));
+	m_childToParentMap.merge(typeUnitParser.m_childToParentMap);
+	m_typeUnitParser.reset();
+}
+
+std::vector<const dwarf::compilation_unit*> Parser::SelectUnits(
+	const std::vector<dwarf::compilation_unit>& units) const noexcept
+{
+	std::vector<const dwarf::compilation_unit*> selectedUnits;
+	const auto selectAll = [&]()
+	{
+		selectedUnits.clear();
+		for (const auto& unit : units)
+			selectedUnits.push_back(&unit);
+		return selectedUnits;
+	};
+	// streamed units are freed before the units that define what they
+	// only declare could be found, so every unit is parsed then
+	if (m_exactRoots.empty() == true || m_inexactRoots == true || m_file == nullptr ||
+		m_stream != nullptr)
+		return selectAll();
+	const AcceleratorIndex index(*m_file);
+	if (index.Valid() == false)
+		return selectAll();
+	std::vector<AcceleratorIndex::Location> locations;
+	for (const auto& root : m_exactRoots)
+	{
+		const size_t found = locations.size();
+		if (FindDefinitions(index, root, locations) == false)
+			return selectAll();
+		// the table may be incomplete, so a missing name is looked for everywhere
+		if (locations.size() == found)
+			return selectAll();
+	}
+	// units are in offset order
+	for (const auto& location : locations)
+	{
+		const auto unitIt = std::ranges::lower_bound(units, location.unitOffset, {},
+			[](const dwarf::compilation_unit& unit) { return unit.get_section_offset(); });
+		if (unitIt != units.end() && unitIt->get_section_offset() == location.unitOffset)
+			selectedUnits.push_back(&*unitIt);
+	}
+	std::ranges::sort(selectedUnits);
+	const auto [duplicatesBegin, duplicatesEnd] = std::ranges::unique(selectedUnits);
+	selectedUnits.erase(duplicatesBegin, duplicatesEnd);
+	return selectedUnits;
+}
+
+std::vector<const dwarf::compilation_unit*> Parser::SelectDefiningUnits(
+	const std::vector<dwarf::compilation_unit>& units,
+	std::unordered_set<const dwarf::compilation_unit*>& parsedUnits,
+	std::unordered_set<std::string>& lookedUp) noexcept
+{
+	std::vector<const dwarf::compilation_unit*> selectedUnits;
+	if (parsedUnits.size() == units.size() || m_file == nullptr)
+		return selectedUnits;
+	std::vector<std::string> names;
+	CollectDeclarations(m_globalNamespace, std::string(), names);
+	const AcceleratorIndex index(*m_file);
+	std::vector<AcceleratorIndex::Location> locations;
+	for (auto& name : names)
+	{
+		if (lookedUp.insert(name).second == false)
+			continue;
+		// a class that is defined nowhere stays declared
+		const size_t found = locations.size();
+		if (FindDefinitions(index, name, locations) == false || locations.size() == found)
+			continue;
+		if (AddRoot(name, false).has_value() == true)
+			locations.resize(found);
+	}
+	for (const auto& location : locations)
+	{
+		const auto unitIt = std::ranges::lower_bound(units, location.unitOffset, {},
+			[](const dwarf::compilation_unit& unit) { return unit.get_section_offset(); });
+		if (unitIt != units.end() && unitIt->get_section_offset() == location.unitOffset &&
+			parsedUnits.insert(&*unitIt).second == true)
+			selectedUnits.push_back(&*unitIt);
+	}
+	std::ranges::sort(selectedUnits);
+	return selectedUnits;
+}
+
+void Parser::CollectDeclarations(const Namespace& scope, const std::string& prefix,
+	std::vector<std::string>& names) noexcept
+{
+	for (const auto& [name, named] : scope.GetSortedConcepts())
+	{
+		std::string qualifiedName = (prefix.empty() == true) ?
+			std::string(name.View()) : prefix + "::" + std::string(name.View());
+		if (named->GetType() == Named::Type::Namespace)
+			CollectDeclarations(*static_cast<const Namespace*>(named), qualifiedName, names);
+		else if (Namespace::IsPrinted(*named) == true &&
+			static_cast<const Class*>(named)->IsDeclaration() == true)
+			names.push_back(std::move(qualifiedName));
+	}
+}
+
+void Parser::ParseCompilationUnit(const dwarf::compilation_unit& unit, TaskPool& pool) noexcept
+{
+	// this must be complete before any DIE is parsed
+	IndexScopes(unit.root());
+	if (m_owner->m_roots.empty() == false)
+		SelectRoots(unit.root());
+	std::vector<dwarf::die> dies;
+	for (const auto& die : unit.root())
+	{
+		if (IsWanted(die) == true)
+			dies.push_back(die);
+	}
+	// the result slots must exist before any task runs
+	m_unitRoots.resize(dies.size());
+	m_unitErrors.resize(dies.size());
+	m_pendingTasks += dies.size();
+	for (size_t dieIndex = 0; dieIndex < dies.size(); ++dieIndex)
+	{
+		pool.Push([this, dieIndex, die = std::move(dies[dieIndex])]()
+			{
+				const auto start = std::chrono::steady_clock::now();
+				// don't bother once any unit has failed
+				if (m_owner->m_failed == false)
+				{
+					auto res = ParseDIE(die);
+					if (res.has_value() == true)
+						m_unitRoots[dieIndex] = std::move(res.value());
+					else
+					{
+						m_unitErrors[dieIndex] = std::move(res.error());
+						m_owner->m_failed = true;
+					}
+				}
+				AddParseTime(start);
+				FinishTask();
+			});
+	}
+}
+
+bool Parser::LoadCompilationUnit(const dwarf::compilation_unit& unit) noexcept
+{
+	if (m_owner->m_unitCacheFile == nullptr)
+		return false;
+	// the roots and the memory budget change what is parsed, so they
+	// are part of the key
+	auto salt = m_owner->m_rootKey;
+	if (m_owner->m_memoryBudget != 0)
+		salt += "budget\n";
+	auto key = GetUnitKey(*m_owner->m_unitCacheFile,
+		unit.get_section_offset(), salt);
+	if (key.has_value() == false)
+		return false;
+	m_unitKey = std::move(key.value());
+	auto roots = ReadCache(UnitCachePath(), m_unitKey, nullptr);
+	if (roots.has_value() == false)
+	{
+		// throw away anything a bad cache left behind
+		m_arena = Arena();
+		m_childToParentMap.clear();
+		return false;
+	}
+	m_unitRoots = std::move(roots.value());
+	m_unitErrors.resize(m_unitRoots.size());
+	m_unitCached = true;
+	return true;
+}
+
+std::optional<std::string> Parser::SaveCompilationUnit() const noexcept
+{
+	const std::vector<const Named*> roots(m_unitRoots.begin(), m_unitRoots.end());
+	return WriteCache(UnitCachePath(), m_unitKey, roots);
+}
+
+std::string Parser::UnitCachePath() const noexcept
+{
+	return (std::filesystem::path(m_owner->m_unitCacheDirectory) / (m_unitKey + ".unit")).string();
+}
+
+void Parser::FinishTask() noexcept
+{
+	if (m_pendingTasks.fetch_sub(1) != 1)
+		return;
+	// take the lock so the owner can't miss the notification
+	{
+		std::scoped_lock lock(m_owner->m_unitMutex);
+	}
+	m_owner->m_unitCondition.notify_all();
+}
+
+void Parser::AddParseTime(std::chrono::steady_clock::time_point start) noexcept
+{
+	m_parseNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+void Parser::AddMergeTime(std::chrono::steady_clock::time_point start) noexcept
+{
+	m_statistics.mergeSeconds += std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+void Parser::RecordUnit(const Parser& unitParser, const dwarf::compilation_unit& unit,
+	size_t bytes) noexcept
+{
+	m_statistics.Merge(unitParser.m_statistics);
+	m_statistics.units.push_back(ParseStatistics::UnitStatistics{ unit.get_section_offset(),
+		bytes, static_cast<double>(unitParser.m_parseNanoseconds) / 1e9,
+		unitParser.m_parsedEntries.Size(), unitParser.m_unitCached });
+}
+
+void Parser::WaitForUnit(const Parser& unitParser) noexcept
+{
+	std::unique_lock lock(m_unitMutex);
+	m_unitCondition.wait(lock, [&unitParser]() { return unitParser.m_pendingTasks == 0; });
+}
+
+std::optional<std::string> Parser::StreamCompilationUnit(Parser& unitParser) noexcept
+{
+	for (auto& error : unitParser.m_unitErrors)
+	{
+		if (error.has_value() == true)
 			return std::move(error);
 	}
+	// a failure in another unit may have skipped some of this one
+	if (m_failed == true)
+		return "Parsing was cancelled";
+	// the unit's concepts are printed by a namespace of their own
+	auto emitted = unitParser.m_arena.Create<Namespace>();
+	for (auto named : unitParser.m_unitRoots)
+	{
+		if (auto error = m_globalNamespace.AddStreamed(*this, unitParser, named, *emitted);
+			error.has_value() == true)
+			return std::move(error);
+	}
+	emitted->PrintToFile(*m_stream);
 	return std::nullopt;
 }
 
-tl::expected<std::shared_ptr<Named>, std::string> Parser::ParseDIE(const dwarf::die& die) noexcept
+std::optional<std::string> Parser::MergeCompilationUnit(Parser& unitParser) noexcept
 {
-	// if we already parsed it, return the entry. use unit and offset to save space
-	const auto parsedIt = m_parsedEntries.find(
-		reinterpret_cast<const char*>(
-		&die.get_unit()) + die.get_section_offset());
-	if (parsedIt != m_parsedEntries.end())
-		return parsedIt->second;
-	std::shared_ptr<Named> result;
-	// todo: make a self-registering factory for this
-	switch (die.tag)
+	for (auto& error : unitParser.m_unitErrors)
+	{
+		if (error.has_value() == true)
+			return std::move(error);
+	}
+	// a failure in another unit may have skipped some of this one
+	if (m_failed == true)
+		return "Parsing was cancelled";
+	// take ownership of the unit's concepts. its memo is keyed by its
+	// own DIEs, which nothing looks up once it is merged, so it is freed
+	unitParser.m_parsedEntries = {};
+	m_arena.Adopt(std::move(unitParser.m_arena));
+	m_childToParentMap.merge(unitParser.m_childToParentMap);
+	for (auto named : unitParser.m_unitRoots)
+	{
+		if (auto error = m_globalNamespace.AddNamed(*this, named);
+			error.has_value() == true)
+			return std::move(error);
+	}
+	unitParser.m_unitRoots.clear();
+	return std::nullopt;
+}
+
+tl::expected<Named*, std::string> Parser::ParseDIE(const dwarf::die& die) noexcept
+{
+	// DIEs referenced while parsing another DIE are queued on the
+	// current traversal, and are parsed before it is finalized
+	if (s_traversal != nullptr && s_traversal->parser == this)
+		return RequestDIE(*s_traversal, die);
+	// only traversals that take long enough are traced
+	TraceScope dieScope("die", "ParseDIE", { { "offset", die.get_section_offset() },
+		{ "tag", static_cast<uint64_t>(die.tag) } }, true);
+	// otherwise, start a new traversal and run it to completion. the
+	// bottom frame only collects the requested entry
+	Traversal traversal{ this, {}, {} };
+	traversal.frames.push_back(Frame{ nullptr, dwarf::die(), true, std::nullopt, {} });
+	const auto previousTraversal = std::exchange(s_traversal, &traversal);
+	auto result = RequestDIE(traversal, die);
+	if (result.has_value() == true)
+	{
+		QueueRequested(traversal);
+		if (auto error = RunTraversal(traversal); error.has_value() == true)
+			result = tl::make_unexpected(std::move(error.value()));
+	}
+	s_traversal = previousTraversal;
+	return result;
+}
+
+namespace
+{
+	// standard tags index the table. vendor tags are spread out and few,
+	// so they are searched
+	constexpr size_t StandardTagCount = 0x80;
+
+	constexpr auto BuiltInHandlers = []()
+	{
+		std::array<Parser::TagHandler, StandardTagCount> handlers{};
+		const auto set = [&handlers](dwarf::DW_TAG tag, Parser::TagHandler handler)
+		{
+			handlers[static_cast<size_t>(tag)] = handler;
+		};
+		set(dwarf::DW_TAG::array_type, Parser::MakeHandler<Array>());
+		set(dwarf::DW_TAG::base_type, Parser::MakeHandler<BasicType>());
+		set(dwarf::DW_TAG::class_type, Parser::MakeHandler<Class>());
+		set(dwarf::DW_TAG::structure_type, Parser::MakeHandler<Class>());
+		set(dwarf::DW_TAG::union_type, Parser::MakeHandler<Class>());
+		set(dwarf::DW_TAG::const_type, Parser::MakeHandler<ConstType>());
+		set(dwarf::DW_TAG::enumeration_type, Parser::MakeHandler<Enum>());
+		set(dwarf::DW_TAG::enumerator, Parser::MakeHandler<Enumerator>());
+		set(dwarf::DW_TAG::formal_parameter, Parser::MakeHandler<Value>());
+		set(dwarf::DW_TAG::member, Parser::MakeHandler<Value>());
+		set(dwarf::DW_TAG::variable, Parser::MakeHandler<Value>());
+		set(dwarf::DW_TAG::imported_declaration, Parser::MakeHandler<Ignored>());
+		set(dwarf::DW_TAG::imported_module, Parser::MakeHandler<Ignored>());
+		set(dwarf::DW_TAG::namespace_, Parser::MakeHandler<Namespace>());
+		set(dwarf::DW_TAG::pointer_type, Parser::MakeHandler<Pointer>());
+		set(dwarf::DW_TAG::ptr_to_member_type, Parser::MakeHandler<PointerToMember>());
+		set(dwarf::DW_TAG::reference_type, Parser::MakeHandler<RefType>());
+		set(dwarf::DW_TAG::rvalue_reference_type, Parser::MakeHandler<RRefType>());
+		set(dwarf::DW_TAG::subprogram, Parser::MakeHandler<SubProgram>());
+		set(dwarf::DW_TAG::subroutine_type, Parser::MakeHandler<Subroutine>());
+		set(dwarf::DW_TAG::template_type_parameter, Parser::MakeHandler<NamedType>());
+		set(dwarf::DW_TAG::template_value_parameter, Parser::MakeHandler<NamedType>());
+		set(dwarf::DW_TAG::typedef_, Parser::MakeHandler<TypeDef>());
+		set(dwarf::DW_TAG::volatile_type, Parser::MakeHandler<VolatileType>());
+		return handlers;
+	}();
+
+	constexpr std::pair<dwarf::DW_TAG, Parser::TagHandler> VendorHandlers[] =
+	{
+		// DW_TAG_GNU_template_template_param
+		{ static_cast<dwarf::DW_TAG>(0x4106), Parser::MakeHandler<Ignored>() },
+	};
+}
+
+const Parser::TagHandler* Parser::FindHandler(dwarf::DW_TAG tag) const noexcept
+{
+	// most parsers have no handlers of their own
+	const auto& handlers = (m_owner != nullptr) ? m_owner->m_handlers : m_handlers;
+	if (handlers.empty() == false)
+	{
+		if (const auto handlerIt = handlers.find(tag); handlerIt != handlers.end())
+			return &handlerIt->second;
+	}
+	const auto index = static_cast<size_t>(tag);
+	if (index < BuiltInHandlers.size())
+		return (BuiltInHandlers[index].create != nullptr) ? &BuiltInHandlers[index] : nullptr;
+	for (const auto& [vendorTag, handler] : VendorHandlers)
+	{
+		if (vendorTag == tag)
+			return &handler;
+	}
+	return nullptr;
+}
+
+tl::expected<Named*, std::string> Parser::RequestDIE(Traversal& traversal,
+	const dwarf::die& die) noexcept
+{
+	// a declaration that names its definition by signature stands
+	// for the type in the type unit
+	if (auto typeDIE = ResolveSignature(die); typeDIE.has_value() == true)
+		return RequestDIE(traversal, typeDIE.value());
+	// if we already parsed it, return the entry
+	std::unique_lock lock(m_parseMutex);
+	const auto key = m_parsedEntries.GetKey(die.get_unit(), die.get_section_offset());
+	auto& tagCounts = m_statistics.tags[die.tag];
+	++tagCounts.visited;
+	if (const auto parsed = m_parsedEntries.Find(key); parsed != nullptr)
+	{
+		++m_statistics.memoHits;
+		return RequestEntry(traversal, *parsed, die);
+	}
+	++m_statistics.memoMisses;
+	// types in type units are parsed by the owner's type unit parser,
+	// however many units reference them. it runs a traversal of its
+	// own to completion, so the type is finished when it returns
+	if (m_owner != nullptr && m_owner->m_typeUnitParser != nullptr &&
+		m_owner->m_typeUnitParser.get() != this && InTypeUnit(die) == true)
+	{
+		lock.unlock();
+		auto shared = m_owner->m_typeUnitParser->ParseDIE(die);
+		if (shared.has_value() == false)
+			return shared;
+		lock.lock();
+		++m_statistics.typeUnitShared;
+		m_parsedEntries.Emplace(key, ParsedEntry{ shared.value(),
+			std::this_thread::get_id(), EntryState::Parsed });
+		return shared;
+	}
+	// classes and enums that another unit already parsed are shared
+	// instead of being parsed again
+	std::optional<OdrKey> odrKey;
+	// units are freed as they are streamed, so nothing is shared then
+	if (m_owner != nullptr && m_owner->m_stream == nullptr &&
+		IsOdrCandidate(die.tag) == true)
+	{
+		lock.unlock();
+		odrKey = GetOdrKey(die);
+		Named* shared = (odrKey.has_value() == true) ?
+			m_owner->FindOdrEntry(odrKey.value()) : nullptr;
+		lock.lock();
+		// another thread may have requested it in the meantime
+		if (const auto parsed = m_parsedEntries.Find(key); parsed != nullptr)
+			return RequestEntry(traversal, *parsed, die);
+		if (shared != nullptr)
+		{
+			++m_statistics.odrShared;
+			m_parsedEntries.Emplace(key, ParsedEntry{ shared,
+				std::this_thread::get_id(), EntryState::Parsed });
+			return shared;
+		}
+	}
+	const auto handler = FindHandler(die.tag);
+	if (handler == nullptr)
+		return tl::make_unexpected("Unimplemented DIE type " + to_string(die.tag));
+	Named* result = handler->create(m_arena);
+	++tagCounts.created;
+	// it is parsed after the DIE that requested it
+	auto& entry = *m_parsedEntries.Emplace(key, ParsedEntry{ result,
+		std::this_thread::get_id(), EntryState::Queued, nullptr, handler }).first;
+	traversal.requested.push_back(Frame{ &entry, die, false, std::move(odrKey), {} });
+	traversal.frames.back().dependencies.push_back(&entry);
+	return result;
+}
+
+Named* Parser::RequestEntry(Traversal& traversal, ParsedEntry& entry,
+	const dwarf::die& die) noexcept
+{
+	if (entry.state == EntryState::Parsed)
+		return entry.named;
+	// an entry we queued earlier must now be parsed before the current
+	// DIE is finalized, so queue it again above the current DIE. the
+	// older frame is skipped once it is reached
+	if (entry.parsingThread == std::this_thread::get_id() &&
+		entry.state == EntryState::Queued)
+		traversal.requested.push_back(Frame{ &entry, die, false, std::nullopt, {} });
+	traversal.frames.back().dependencies.push_back(&entry);
+	return entry.named;
+}
+
+std::optional<std::string> Parser::RunTraversal(Traversal& traversal) noexcept
+{
+	auto& frames = traversal.frames;
+	while (frames.empty() == false)
+	{
+		auto& frame = frames.back();
+		if (frame.expanded == false)
+		{
+			{
+				std::scoped_lock lock(m_parseMutex);
+				// the entry may have been parsed from a newer frame, or
+				// adopted by another thread
+				if (frame.entry->state != EntryState::Queued ||
+					frame.entry->frame != &frame)
+				{
+					frames.pop_back();
+					continue;
+				}
+				frame.entry->state = EntryState::Parsing;
+				frame.entry->frame = nullptr;
+			}
+			frame.expanded = true;
+			if (auto error = frame.entry->handler->parse(*frame.entry->named, *this, frame.die);
+				error.has_value() == true)
+			{
+				AbortTraversal(traversal);
+				return std::move(error);
+			}
+			QueueRequested(traversal);
+			continue;
+		}
+		// everything the entry references must be parsed before it is
+		// finalized. waiting may adopt another thread's queued entry,
+		// in which case that entry is parsed first
+		if (WaitForDependencies(traversal, frame) == false)
+			continue;
+		if (frame.entry == nullptr)
+		{
+			frames.pop_back();
+			continue;
+		}
+		if (auto error = frame.entry->named->Finalize(*this);
+			error.has_value() == true)
+		{
+			AbortTraversal(traversal);
+			return std::move(error);
+		}
+		{
+			std::scoped_lock lock(m_parseMutex);
+			frame.entry->state = EntryState::Parsed;
+		}
+		m_parseCondition.notify_all();
+		// only share complete entries. if another unit got there
+		// first, this unit just keeps its own copy
+		if (frame.odrKey.has_value() == true)
+			m_owner->AddOdrEntry(std::move(frame.odrKey.value()), frame.entry->named);
+		frames.pop_back();
+	}
+	return std::nullopt;
+}
+
+void Parser::QueueRequested(Traversal& traversal) noexcept
+{
+	// push in reverse so entries are parsed in the order they were requested
+	std::scoped_lock lock(m_parseMutex);
+	for (auto& requested : traversal.requested | std::views::reverse)
+	{
+		auto& frame = traversal.frames.emplace_back(std::move(requested));
+		// an entry queued again replaces its older frame
+		if (frame.entry->frame != nullptr && frame.odrKey.has_value() == false)
+			frame.odrKey = std::move(frame.entry->frame->odrKey);
+		frame.entry->frame = &frame;
+	}
+	traversal.requested.clear();
+}
+
+bool Parser::WaitForDependencies(Traversal& traversal, Frame& frame) noexcept
+{
+	std::unique_lock lock(m_parseMutex);
+	for (auto dependency : frame.dependencies)
+	{
+		if (WaitForEntry(lock, traversal, *dependency) == false)
+			return false;
+	}
+	frame.dependencies.clear();
+	return true;
+}
+
+bool Parser::WaitForEntry(std::unique_lock<std::mutex>& lock,
+	Traversal& traversal, ParsedEntry& entry) noexcept
+{
+	const auto thisThread = std::this_thread::get_id();
+	while (entry.state != EntryState::Parsed)
+	{
+		// an entry this thread is still parsing is part of a reference
+		// cycle, and is used as-is
+		if (entry.parsingThread == thisThread)
+		{
+			m_cycleNamesPending |= HasDerivedName(*entry.named);
+			return true;
+		}
+		// the same goes for an entry whose thread is transitively
+		// waiting on us, since it cannot progress until we do
+		auto parsingThread = entry.parsingThread;
+		for (size_t depth = 0; parsingThread != thisThread &&
+			depth < m_waitingThreads.size(); ++depth)
+		{
+			const auto waitingIt = m_waitingThreads.find(parsingThread);
+			if (waitingIt == m_waitingThreads.end())
+				break;
+			parsingThread = waitingIt->second->parsingThread;
+		}
+		if (parsingThread == thisThread)
+		{
+			// that thread has not started on the entry yet, so take it
+			// over. its frame is safe to read since its thread is blocked
+			if (entry.state == EntryState::Queued && entry.frame != nullptr)
+			{
+				entry.parsingThread = thisThread;
+				auto& frame = traversal.frames.emplace_back(
+					Frame{ &entry, entry.frame->die, false, std::move(entry.frame->odrKey), {} });
+				entry.frame = &frame;
+				return false;
+			}
+			// it has started, so it is safe to read while its thread is blocked
+			m_cycleNamesPending |= HasDerivedName(*entry.named);
+			return true;
+		}
+		m_waitingThreads[thisThread] = &entry;
+		m_parseCondition.wait(lock);
+		m_waitingThreads.erase(thisThread);
+	}
+	return true;
+}
+
+bool Parser::HasDerivedName(const Named& named) noexcept
+{
+	if (named.GetType() != Named::Type::Typed)
+		return false;
+	switch (static_cast<const Typed&>(named).GetTypeCode())
+	{
+	case Typed::TypeCode::Array:
+	case Typed::TypeCode::ConstType:
+	case Typed::TypeCode::Pointer:
+	case Typed::TypeCode::RefType:
+	case Typed::TypeCode::RRefType:
+	case Typed::TypeCode::Subroutine:
+	case Typed::TypeCode::VolatileType:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void Parser::DeriveCycleNames() noexcept
+{
+	if (m_cycleNamesPending == false)
+		return;
+	m_cycleNamesPending = false;
+	// derived names only depend on the names they reference, so this
+	// ends with the names a single thread parsing in order would give
+	bool changed = true;
+	bool renamed = false;
+	for (size_t pass = 0; changed == true && pass <= m_parsedEntries.Size(); ++pass)
+	{
+		changed = false;
+		m_parsedEntries.ForEach([this, &changed](ParsedEntry& entry)
+			{
+				// entries shared from other parsers are theirs to name
+				if (entry.handler == nullptr || HasDerivedName(*entry.named) == false)
+					return;
+				const auto name = entry.named->GetInternedName();
+				entry.named->Finalize(*this);
+				changed |= (entry.named->GetInternedName() != name);
+			});
+		renamed |= changed;
+	}
+	if (renamed == false)
+		return;
+	// namespaces keyed their children when they were finalized, which
+	// may have been before the names above were derived
+	m_parsedEntries.ForEach([this](ParsedEntry& entry)
+		{
+			if (entry.handler != nullptr && entry.named->GetType() == Named::Type::Namespace)
+				static_cast<Namespace*>(entry.named)->RekeyConcepts(*this);
+		});
+}
+
+void Parser::AbortTraversal(Traversal& traversal) noexcept
+{
+	// mark everything unfinished as parsed so other threads stop waiting
+	{
+		std::scoped_lock lock(m_parseMutex);
+		const auto thisThread = std::this_thread::get_id();
+		for (auto& frame : traversal.frames)
+		{
+			if (frame.entry != nullptr && frame.entry->parsingThread == thisThread)
+			{
+				frame.entry->state = EntryState::Parsed;
+				frame.entry->frame = nullptr;
+			}
+		}
+		for (auto& requested : traversal.requested)
+			requested.entry->state = EntryState::Parsed;
+	}
+	m_parseCondition.notify_all();
+	traversal.frames.clear();
+	traversal.requested.clear();
+}
+
+void Parser::IndexScopes(const dwarf::die& root) noexcept
+{
+	// walk namespaces and classes with a stack since classes can
+	// nest deeply. anonymous scopes have internal linkage, so
+	// nothing inside of them is shared between units
+	std::vector<std::pair<dwarf::die, std::string>> scopes;
+	scopes.emplace_back(root, std::string());
+	while (scopes.empty() == false)
+	{
+		auto [scope, prefix] = std::move(scopes.back());
+		scopes.pop_back();
+		for (const auto& child : scope)
+		{
+			if (child.tag != dwarf::DW_TAG::namespace_ &&
+				IsOdrCandidate(child.tag) == false)
+				continue;
+			if (child.has(dwarf::DW_AT::name) == false)
+				continue;
+			const std::string_view name = child[dwarf::DW_AT::name].as_cstr();
+			std::string qualifiedName = (prefix.empty() == true) ?
+				std::string(name) : prefix + "::" + std::string(name);
+			if (child.tag != dwarf::DW_TAG::namespace_)
+				m_qualifiedNames.emplace(child.get_section_offset(), Intern(qualifiedName));
+			if (child.tag != dwarf::DW_TAG::enumeration_type)
+				scopes.emplace_back(child, std::move(qualifiedName));
+		}
+	}
+}
+
+void Parser::SelectRoots(const dwarf::die& root) noexcept
+{
+	const auto& roots = m_owner->m_roots;
+	// the scope each named DIE is in, so that the scopes of a wanted
+	// DIE are parsed as well
+	std::unordered_map<dwarf::section_offset, dwarf::section_offset> scopeParents;
+	// the DIEs whose references still have to be followed
+	std::vector<dwarf::die> reachable;
+	const auto want = [&](dwarf::section_offset offset)
+	{
+		while (m_wantedDIEs.insert(offset).second == true)
+		{
+			const auto parentIt = scopeParents.find(offset);
+			if (parentIt == scopeParents.end())
+				break;
+			offset = parentIt->second;
+		}
+	};
+	// first, match the qualified name of everything in a namespace
+	// or class against the roots. nothing in a matched namespace
+	// has to be matched again
+	struct Scope
+	{
+		dwarf::die die;
+		std::string prefix;
+		bool matched;
+	};
+	std::vector<Scope> scopes;
+	scopes.push_back(Scope{ root, std::string(), false });
+	while (scopes.empty() == false)
+	{
+		auto scope = std::move(scopes.back());
+		scopes.pop_back();
+		const bool inClass = (scope.die.tag != dwarf::DW_TAG::namespace_ &&
+			scope.die.tag != dwarf::DW_TAG::compile_unit);
+		for (const auto& child : scope.die)
+		{
+			// classes are parsed whole, so only their nested types matter
+			if (inClass == true && IsOdrCandidate(child.tag) == false &&
+				child.tag != dwarf::DW_TAG::typedef_)
+				continue;
+			const auto offset = child.get_section_offset();
+			scopeParents.emplace(offset, scope.die.get_section_offset());
+			std::string qualifiedName = scope.prefix;
+			if (child.has(dwarf::DW_AT::name) == true)
+			{
+				if (qualifiedName.empty() == false)
+					qualifiedName += "::";
+				qualifiedName += child[dwarf::DW_AT::name].as_cstr();
+			}
+			bool matched = (scope.matched == true);
+			if (matched == false && qualifiedName.size() != scope.prefix.size())
+			{
+				matched = std::ranges::any_of(roots, [&](const std::regex& pattern)
+					{
+						return std::regex_match(qualifiedName, pattern);
+					});
+			}
+			if (matched == true)
+			{
+				want(offset);
+				reachable.push_back(child);
+			}
+			if (child.tag == dwarf::DW_TAG::namespace_ ||
+				IsOdrCandidate(child.tag) == true)
+				scopes.push_back(Scope{ child, std::move(qualifiedName), matched });
+		}
+	}
+	// then follow references from the matched DIEs without parsing
+	// them. referenced scope-level DIEs are wanted too
+	std::unordered_set<dwarf::section_offset> visited;
+	while (reachable.empty() == false)
+	{
+		const auto die = std::move(reachable.back());
+		reachable.pop_back();
+		if (visited.insert(die.get_section_offset()).second == false)
+			continue;
+		// declarations in a unit name their type unit's type by signature
+		const Attributes attributes(die);
+		for (const auto attribute : { dwarf::DW_AT::type,
+			dwarf::DW_AT::containing_type, dwarf::DW_AT::specification,
+			dwarf::DW_AT::signature })
+		{
+			const auto reference = attributes.Resolve(attribute);
+			if (reference.valid() == false ||
+				reference.get_type() != dwarf::value::type::reference)
+				continue;
+			auto referenced = reference.as_reference();
+			if (scopeParents.contains(referenced.get_section_offset()) == true)
+				want(referenced.get_section_offset());
+			reachable.push_back(std::move(referenced));
+		}
+		// members, parameters and inheritance are children
+		for (const auto& child : die)
+			reachable.push_back(child);
+	}
+}
+
+bool Parser::IsWanted(const dwarf::die& die) const noexcept
+{
+	// functions and variables are never printed, so with a memory
+	// budget they aren't parsed at all. definitions of declared methods
+	// are, since they name the parameters of their declarations
+	if (m_owner != nullptr && m_owner->m_memoryBudget != 0 &&
+		(die.tag == dwarf::DW_TAG::variable || (die.tag == dwarf::DW_TAG::subprogram &&
+		die.has(dwarf::DW_AT::specification) == false)))
+		return false;
+	if (m_owner == nullptr || m_owner->m_roots.empty() == true)
+		return true;
+	return m_wantedDIEs.contains(die.get_section_offset());
+}
+
+bool Parser::IsOdrCandidate(dwarf::DW_TAG tag) noexcept
+{
+	switch (tag)
 	{
-	case dwarf::DW_TAG::array_type:
-		result = std::make_shared<Array>();
-		break;
-	case dwarf::DW_TAG::base_type:
-		result = std::make_shared<BasicType>();
-		break;
 	case dwarf::DW_TAG::class_type:
+	case dwarf::DW_TAG::enumeration_type:
 	case dwarf::DW_TAG::structure_type:
 	case dwarf::DW_TAG::union_type:
-		result = std::make_shared<Class>();
-		break;
-	case dwarf::DW_TAG::const_type:
-		result = std::make_shared<ConstType>();
-		break;
-	case dwarf::DW_TAG::enumeration_type:
-		result = std::make_shared<Enum>();
-		break;
-	case dwarf::DW_TAG::enumerator:
-		result = std::make_shared<Enumerator>();
-		break;
-	case dwarf::DW_TAG::formal_parameter:
-	case dwarf::DW_TAG::member:
-	case dwarf::DW_TAG::variable:
-		result = std::make_shared<Value>();
-		break;
-	case dwarf::DW_TAG::imported_declaration:
-	case dwarf::DW_TAG::imported_module:
-	case static_cast<dwarf::DW_TAG>(0x4106):
-		result = std::make_shared<Ignored>();
-		break;
-	case dwarf::DW_TAG::namespace_:
-		result = std::make_shared<Namespace>();
-		break;
-	case dwarf::DW_TAG::pointer_type:
-		result = std::make_shared<Pointer>();
-		break;
-	case dwarf::DW_TAG::ptr_to_member_type:
-		result = std::make_shared<PointerToMember>();
-		break;
-	case dwarf::DW_TAG::reference_type:
-		result = std::make_shared<RefType>();
-		break;
-	case dwarf::DW_TAG::rvalue_reference_type:
-		result = std::make_shared<RRefType>();
-		break;
-	case dwarf::DW_TAG::subprogram:
-		result = std::make_shared<SubProgram>();
-		break;
-	case dwarf::DW_TAG::subroutine_type:
-		result = std::make_shared<Subroutine>();
-		break;
-	case dwarf::DW_TAG::template_type_parameter:
-	case dwarf::DW_TAG::template_value_parameter:
-		result = std::make_shared<NamedType>();
-		break;
-	case dwarf::DW_TAG::typedef_:
-		result = std::make_shared<TypeDef>();
-		break;
-	case dwarf::DW_TAG::volatile_type:
-		result = std::make_shared<VolatileType>();
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::optional<Parser::OdrKey> Parser::GetOdrKey(const dwarf::die& die) const noexcept
+{
+	// only named types at namespace or class scope are indexed
+	const auto nameIt = m_qualifiedNames.find(die.get_section_offset());
+	if (nameIt == m_qualifiedNames.end())
+		return std::nullopt;
+	// FNV-1a over the parts of the definition that distinguish it, so
+	// a declaration or an ODR violation is not mistaken for the definition
+	uint64_t hash = 0xcbf29ce484222325;
+	const auto mix = [&hash](uint64_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); ++i, value >>= 8)
+			hash = (hash ^ (value & 0xff)) * 0x100000001b3;
+	};
+	const auto mixString = [&hash, &mix](std::string_view str)
+	{
+		for (const char c : str)
+			hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+		mix(str.size());
+	};
+	// a referenced type is described by the named type at the end of
+	// any unnamed pointers and modifiers, by its qualified name where it
+	// has one, so that types of the same name in other scopes differ
+	const auto mixType = [this, &die, &mix, &mixString](dwarf::die type)
+	{
+		for (size_t depth = 0; depth < 16; ++depth)
+		{
+			mix(static_cast<uint64_t>(type.tag));
+			if (type.has(dwarf::DW_AT::name) == true)
+			{
+				// qualified names are only indexed for this unit
+				const auto qualifiedIt = (&type.get_unit() == &die.get_unit()) ?
+					m_qualifiedNames.find(type.get_section_offset()) : m_qualifiedNames.end();
+				mixString((qualifiedIt != m_qualifiedNames.end()) ? qualifiedIt->second.View() :
+					std::string_view(type[dwarf::DW_AT::name].as_cstr()));
+				return;
+			}
+			if (type.has(dwarf::DW_AT::type) == false)
+				return;
+			type = type[dwarf::DW_AT::type].as_reference();
+		}
+	};
+	const auto mixEntry = [&mix, &mixString, &mixType](const dwarf::die& entry)
+	{
+		const Attributes attributes(entry);
+		mix(static_cast<uint64_t>(entry.tag));
+		if (attributes.Has(dwarf::DW_AT::name) == true)
+			mixString(attributes.Get(dwarf::DW_AT::name).as_cstr());
+		if (attributes.Has(dwarf::DW_AT::byte_size) == true)
+			mix(attributes.Get(dwarf::DW_AT::byte_size).as_uconstant());
+		if (attributes.Has(dwarf::DW_AT::declaration) == true)
+			mix(1);
+		for (const auto attribute : { dwarf::DW_AT::data_member_location, dwarf::DW_AT::const_value })
+		{
+			if (attributes.Has(attribute) == false)
+				continue;
+			const auto value = attributes.Get(attribute);
+			if (value.get_type() == dwarf::value::type::sconstant)
+				mix(static_cast<uint64_t>(value.as_sconstant()));
+			else if (value.get_type() == dwarf::value::type::uconstant ||
+				value.get_type() == dwarf::value::type::constant)
+				mix(value.as_uconstant());
+		}
+		if (attributes.Has(dwarf::DW_AT::type) == true)
+			mixType(attributes.Get(dwarf::DW_AT::type).as_reference());
+	};
+	mixEntry(die);
+	for (const auto& child : die)
+		mixEntry(child);
+	return OdrKey{ nameIt->second, hash };
+}
+
+Named* Parser::FindOdrEntry(const OdrKey& key) noexcept
+{
+	if (m_typeStore != nullptr)
+		return m_typeStore->FindOdrEntry(key);
+	std::scoped_lock lock(m_odrMutex);
+	const auto entryIt = m_odrEntries.find(key);
+	return (entryIt != m_odrEntries.end()) ? entryIt->second : nullptr;
+}
+
+void Parser::AddOdrEntry(OdrKey key, Named* named) noexcept
+{
+	if (m_typeStore != nullptr)
+		return m_typeStore->AddOdrEntry(std::move(key), named);
+	std::scoped_lock lock(m_odrMutex);
+	if (const auto entryIt = m_odrEntries.find(key); entryIt == m_odrEntries.end())
+		m_odrEntries.emplace(std::move(key), named);
+	else if (entryIt->second != named)
+		m_odrDuplicates.emplace_back(std::move(key), named);
+}
+
+std::optional<std::string> Parser::AddRoot(std::string_view pattern, bool regex) noexcept
+{
+	std::string expression;
+	if (regex == true)
+		expression = pattern;
+	else
+	{
+		// translate the glob to an equivalent regular expression
+		for (const auto c : pattern)
+		{
+			if (c == '*')
+				expression += ".*";
+			else if (c == '?')
+				expression += '.';
+			else
+			{
+				if (std::string_view("\\^$.|+()[]{}").find(c) != std::string_view::npos)
+					expression += '\\';
+				expression += c;
+			}
+		}
+	}
+	try
+	{
+		m_roots.emplace_back(expression, std::regex::ECMAScript | std::regex::optimize);
+	}
+	catch (const std::regex_error& e)
+	{
+		return "Invalid root pattern " + std::string(pattern) + ": " + e.what();
+	}
+	m_rootKey += expression + '\n';
+	if (regex == false && pattern.find_first_of("*?") == std::string_view::npos)
+		m_exactRoots.emplace_back(pattern);
+	else
+		m_inexactRoots = true;
+	return std::nullopt;
+}
+
+std::optional<std::string> Parser::SaveCache(const std::string& path, std::string_view key) const noexcept
+{
+	// the global namespace is always the first concept
+	return WriteCache(path, key, { &m_globalNamespace });
+}
+
+std::optional<std::string> Parser::LoadCache(const std::string& path, std::string_view key) noexcept
+{
+	auto roots = ReadCache(path, key, &m_globalNamespace);
+	if (roots.has_value() == false)
+		return std::move(roots.error());
+	if (roots.value().size() != 1 || roots.value().front() != &m_globalNamespace)
+		return "The cache is corrupt";
+	return std::nullopt;
+}
+
+void Parser::SetUnitCache(std::string directory, const elf::elf& file) noexcept
+{
+	m_unitCacheDirectory = std::move(directory);
+	m_unitCacheFile = &file;
+	SetFile(file);
+}
+
+void Parser::SetFile(const elf::elf& file) noexcept
+{
+	m_file = &file;
+	const auto& info = file.get_section(".debug_info");
+	m_infoSize = (info.valid() == true) ? info.size() : 0;
+}
+
+std::optional<std::string> Parser::WriteCache(const std::string& path, std::string_view key,
+	const std::vector<const Named*>& roots) const noexcept
+{
+	CacheWriter writer;
+	// everything the roots reference is queued as it is written
+	writer.Write(roots.size());
+	for (const auto root : roots)
+		writer.WriteReference(root);
+	for (size_t nodeIndex = 0; nodeIndex < writer.NodeCount(); ++nodeIndex)
+		writer.GetNode(nodeIndex)->Serialize(writer);
+	// only keep relationships between written concepts
+	std::vector<std::pair<const Named*, const Named*>> parents;
+	for (const auto& parentPair : m_childToParentMap)
+	{
+		if (writer.Contains(parentPair.first) == true &&
+			writer.Contains(parentPair.second) == true)
+			parents.push_back(parentPair);
+	}
+	writer.Write(parents.size());
+	for (const auto& [child, parent] : parents)
+	{
+		writer.WriteReference(child);
+		writer.WriteReference(parent);
+	}
+	return writer.Finish(path, key);
+}
+
+tl::expected<std::vector<Named*>, std::string> Parser::ReadCache(const std::string& path,
+	std::string_view key, Namespace* globalNamespace) noexcept
+{
+	// names are interned in the owner's pool, like when parsing
+	CacheReader reader(GetStringPool());
+	if (auto error = reader.Open(path, key); error.has_value() == true)
+		return tl::make_unexpected(std::move(error.value()));
+	// create every concept first so that they can refer to each other
+	const auto& nodeKinds = reader.NodeKinds();
+	std::vector<Named*> nodes;
+	nodes.reserve(nodeKinds.size());
+	for (const auto& [type, typeCode] : nodeKinds)
+	{
+		// the global namespace is not allocated
+		const auto node = (nodes.empty() == true && globalNamespace != nullptr &&
+			type == Named::Type::Namespace) ? globalNamespace : CreateNode(type, typeCode);
+		if (node == nullptr)
+			return tl::make_unexpected("The cache is corrupt");
+		nodes.push_back(node);
+	}
+	reader.SetNodes(nodes);
+	std::vector<Named*> roots(reader.ReadCount());
+	for (auto& root : roots)
+		root = reader.ReadReference<Named>();
+	for (const auto node : nodes)
+	{
+		if (auto error = node->Deserialize(reader); error.has_value() == true)
+			return tl::make_unexpected(std::move(error.value()));
+	}
+	const auto parentCount = reader.ReadCount();
+	for (uint64_t i = 0; i < parentCount; ++i)
+	{
+		const auto child = reader.ReadReference<Named>();
+		const auto parent = reader.ReadReference<Named>();
+		m_childToParentMap.emplace(child, parent);
+	}
+	if (auto error = reader.Error(); error.has_value() == true)
+		return tl::make_unexpected(std::move(error.value()));
+	return roots;
+}
+
+Named* Parser::CreateNode(Named::Type type, Typed::TypeCode typeCode) noexcept
+{
+	switch (type)
+	{
+	case Named::Type::Enumerator:
+		return m_arena.Create<Enumerator>();
+	case Named::Type::Ignored:
+		return m_arena.Create<Ignored>();
+	case Named::Type::Namespace:
+		return m_arena.Create<Namespace>();
+	case Named::Type::SubProgram:
+		return m_arena.Create<SubProgram>();
+	case Named::Type::Value:
+		return m_arena.Create<Value>();
+	case Named::Type::Typed:
 		break;
 	default:
-		return tl::make_unexpected("Unimplemented DIE type " + to_string(die.tag));
+		return nullptr;
+	}
+	switch (typeCode)
+	{
+	case Typed::TypeCode::Array:
+		return m_arena.Create<Array>();
+	case Typed::TypeCode::Basic:
+		return m_arena.Create<BasicType>();
+	case Typed::TypeCode::Class:
+		return m_arena.Create<Class>();
+	case Typed::TypeCode::ConstType:
+		return m_arena.Create<ConstType>();
+	case Typed::TypeCode::Enum:
+		return m_arena.Create<Enum>();
+	case Typed::TypeCode::NamedType:
+		return m_arena.Create<NamedType>();
+	case Typed::TypeCode::Pointer:
+		return m_arena.Create<Pointer>();
+	case Typed::TypeCode::PointerToMember:
+		return m_arena.Create<PointerToMember>();
+	case Typed::TypeCode::RefType:
+		return m_arena.Create<RefType>();
+	case Typed::TypeCode::RRefType:
+		return m_arena.Create<RRefType>();
+	case Typed::TypeCode::Subroutine:
+		return m_arena.Create<Subroutine>();
+	case Typed::TypeCode::TypeDef:
+		return m_arena.Create<TypeDef>();
+	case Typed::TypeCode::VolatileType:
+		return m_arena.Create<VolatileType>();
+	default:
+		return nullptr;
 	}
-	m_parsedEntries.emplace(reinterpret_cast<const char*>(
-			&die.get_unit()) + die.get_section_offset(), result);
-	if (auto parseRes = result->ParseDIE(*this, die);
-		parseRes.has_value() == true)
-		return tl::make_unexpected(std::move(parseRes.value()));
-	return std::move(result);
 }
 
-void Parser::PrintToFile(std::ofstream& outFile) noexcept
+void Parser::PrintToFile(std::ostream& outFile) noexcept
 {
 	// print the global namespace
 	m_globalNamespace.PrintToFile(outFile);
+}
+
+std::optional<std::string> Parser::PrintToDirectory(const std::string& directory,
+	bool perClass) noexcept
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error)
+		return "Failed to create output directory " + directory + ": " + error.message();
+	// decide every path up front so they do not depend on which
+	// thread prints first
+	std::vector<OutputHeader> headers;
+	std::unordered_set<std::string> usedPaths{ "all.h" };
+	std::vector<std::string_view> namespaces;
+	CollectHeaders(m_globalNamespace, namespaces, perClass, headers, usedPaths);
+	// a header includes the others that define what it references, so
+	// everything it prints is defined in it or in them
+	std::unordered_map<const Named*, size_t> definedIn;
+	for (size_t headerIndex = 0; headerIndex < headers.size(); ++headerIndex)
+	{
+		std::vector<const Named*> pending(headers[headerIndex].concepts.begin(),
+			headers[headerIndex].concepts.end());
+		while (pending.empty() == false)
+		{
+			const auto named = pending.back();
+			pending.pop_back();
+			definedIn.emplace(named, headerIndex);
+			if (named->GetType() == Named::Type::Namespace)
+			{
+				for (const auto& [name, child] : static_cast<const Namespace*>(named)->GetNamedConcepts())
+				{
+					if (Namespace::IsPrinted(*child) == true)
+						pending.push_back(child);
+				}
+			}
+			else if (named->GetType() == Named::Type::Typed &&
+				static_cast<const Typed*>(named)->GetTypeCode() == Typed::TypeCode::Class)
+			{
+				for (const auto& [member, accessibility] : static_cast<const Class*>(named)->GetMembers())
+					pending.push_back(member);
+			}
+		}
+	}
+	std::vector<char> printed(headers.size(), false);
+	TaskPool pool(m_threadCount);
+	for (size_t headerIndex = 0; headerIndex < headers.size(); ++headerIndex)
+	{
+		pool.Push([&directory, &headers, &definedIn, &header = headers[headerIndex],
+			&result = printed[headerIndex]]()
+			{
+				TraceScope headerScope("print", header.path);
+				CollectIncludes(header, headers, definedIn);
+				const auto path = std::filesystem::path(directory) / header.path;
+				std::error_code createError;
+				std::filesystem::create_directories(path.parent_path(), createError);
+				BufferedWriter outBuffer(path.string(), 1 << 20);
+				std::ostream outFile(&outBuffer);
+				outFile << "#pragma once\n\n";
+				PrintHeader(outFile, header);
+				outFile.flush();
+				result = outBuffer.Close();
+			});
+	}
+	pool.Run();
+	for (size_t headerIndex = 0; headerIndex < headers.size(); ++headerIndex)
+	{
+		if (printed[headerIndex] == false)
+			return "Failed to write header " + headers[headerIndex].path;
+	}
+	// the umbrella header includes everything in a stable order
+	std::vector<std::string> includes;
+	for (const auto& header : headers)
+		includes.push_back(header.path);
+	std::sort(includes.begin(), includes.end());
+	BufferedWriter umbrellaBuffer((std::filesystem::path(directory) / "all.h").string(), 1 << 16);
+	std::ostream umbrellaFile(&umbrellaBuffer);
+	umbrellaFile << "#pragma once\n\n";
+	for (const auto& include : includes)
+		umbrellaFile << "#include \"" << include << "\"\n";
+	umbrellaFile.flush();
+	if (umbrellaBuffer.Close() == false)
+		return "Failed to write header all.h";
+	return std::nullopt;
+}
+
+void Parser::CollectIncludes(OutputHeader& header, const std::vector<OutputHeader>& headers,
+	const std::unordered_map<const Named*, size_t>& definedIn) noexcept
+{
+	// walk everything the header references the way a cache would be
+	// written, but stop at concepts other headers define
+	CacheWriter writer;
+	for (const auto named : header.concepts)
+		writer.WriteReference(named);
+	std::set<std::string> includes;
+	const auto headerDirectory = std::filesystem::path(header.path).parent_path();
+	for (size_t nodeIndex = 0; nodeIndex < writer.NodeCount(); ++nodeIndex)
+	{
+		const auto named = writer.GetNode(nodeIndex);
+		if (const auto definedIt = definedIn.find(named); definedIt != definedIn.end() &&
+			headers[definedIt->second].path != header.path)
+		{
+			includes.insert(std::filesystem::path(headers[definedIt->second].path)
+				.lexically_relative(headerDirectory).generic_string());
+			continue;
+		}
+		// only the concepts a namespace prints are referenced by it
+		if (named->GetType() == Named::Type::Namespace)
+		{
+			for (const auto& [name, child] : static_cast<const Namespace*>(named)->GetSortedConcepts())
+			{
+				if (Namespace::IsPrinted(*child) == true)
+					writer.WriteReference(child);
+			}
+		}
+		else
+			named->Serialize(writer);
+	}
+	header.includes.assign(includes.begin(), includes.end());
+}
+
+void Parser::PrintHeader(std::ostream& outFile, const OutputHeader& header) noexcept
+{
+	for (const auto& include : header.includes)
+		outFile << "#include \"" << include << "\"\n";
+	if (header.includes.empty() == false)
+		outFile << '\n';
+	for (size_t i = 0; i < header.namespaces.size(); ++i)
+	{
+		const std::string indents(i, '\t');
+		outFile << indents << "namespace " << header.namespaces[i] << "\n";
+		outFile << indents << "{\n";
+	}
+	for (const auto named : header.concepts)
+		named->PrintToFile(outFile, header.namespaces.size());
+	for (size_t i = header.namespaces.size(); i-- > 0;)
+		outFile << std::string(i, '\t') << "};\n";
+}
+
+void Parser::CollectHeaders(const Namespace& scope, std::vector<std::string_view>& namespaces,
+	bool perClass, std::vector<OutputHeader>& headers,
+	std::unordered_set<std::string>& usedPaths) const noexcept
+{
+	// names may have characters that paths can't, and may collide
+	// once those are replaced
+	const auto makePath = [&](std::string_view name)
+	{
+		std::string path;
+		for (const auto ns : namespaces)
+		{
+			for (const auto c : ns)
+				path += (std::isalnum(static_cast<unsigned char>(c)) != 0) ? c : '_';
+			path += '/';
+		}
+		for (const auto c : name)
+			path += (std::isalnum(static_cast<unsigned char>(c)) != 0) ? c : '_';
+		std::string uniquePath = path + ".h";
+		for (size_t suffix = 1; usedPaths.insert(uniquePath).second == false; ++suffix)
+			uniquePath = path + '_' + std::to_string(suffix) + ".h";
+		return uniquePath;
+	};
+	// classes that do not get their own header share one per namespace
+	OutputHeader sharedHeader;
+	for (const auto& [name, named] : scope.GetSortedConcepts())
+	{
+		if (Namespace::IsPrinted(*named) == false)
+			continue;
+		if (named->GetType() == Named::Type::Namespace)
+		{
+			// top-level namespaces get their own header, unless their
+			// classes do
+			if (perClass == false)
+				headers.push_back(OutputHeader{ makePath(name.View()), namespaces, { named }, {} });
+			else
+			{
+				namespaces.push_back(name.View());
+				CollectHeaders(*static_cast<const Namespace*>(named), namespaces,
+					perClass, headers, usedPaths);
+				namespaces.pop_back();
+			}
+			continue;
+		}
+		if (perClass == true)
+			headers.push_back(OutputHeader{ makePath(name.View()), namespaces, { named }, {} });
+		else
+			sharedHeader.concepts.push_back(named);
+	}
+	if (sharedHeader.concepts.empty() == false)
+	{
+		sharedHeader.path = makePath("global");
+		sharedHeader.namespaces = namespaces;
+		headers.push_back(std::move(sharedHeader));
+	}
 }
\ No newline at end of file
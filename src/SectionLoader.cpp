@@ -0,0 +1,279 @@
+#include <DWARFToCPP/SectionLoader.h>
+#include <DWARFToCPP/TaskPool.h>
+#include <DWARFToCPP/Tracer.h>
+
+#ifdef DWARFTOCPP_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	// SHF_COMPRESSED, which libelfin doesn't name
+	constexpr uint64_t CompressedFlag = 0x800;
+	// ELFCOMPRESS_ZLIB
+	constexpr uint32_t CompressZlib = 1;
+	// deflate can't expand a byte past this many, so a header that
+	// claims more is corrupt and isn't allocated for
+	constexpr size_t MaxInflateRatio = 1032;
+	// the sections every parse reads
+	constexpr dwarf::section_type EagerSections[] = { dwarf::section_type::info,
+		dwarf::section_type::abbrev, dwarf::section_type::str };
+}
+
+SectionLoader::SectionLoader(const elf::elf& file) noexcept
+{
+	const bool is64 = (file.get_hdr().ei_class == elf::elfclass::_64);
+	for (const auto& elfSection : file.sections())
+	{
+		// .zdebug_* sections are named after the section they compress
+		auto name = elfSection.get_name();
+		const bool prefixed = (name.starts_with(".zdebug_") == true);
+		if (prefixed == true)
+			name.erase(1, 1);
+		if (name.ends_with(".dwo") == true)
+			name.erase(name.size() - 4);
+		dwarf::section_type type;
+		if (dwarf::elf::elf_type_to_section_type(name, &type) == false)
+			continue;
+		auto section = std::make_unique<Section>();
+		section->fileData = static_cast<const uint8_t*>(elfSection.data());
+		section->fileSize = elfSection.size();
+		section->data = section->fileData;
+		section->size = section->fileSize;
+		if (IsCompressed(elfSection) == true)
+		{
+			const bool flagged = (prefixed == false);
+			ReadHeader(*section, elfSection.get_name(), flagged, is64);
+		}
+		m_sections[type] = std::move(section);
+	}
+}
+
+SectionLoader::SectionLoader(SectionLoader& package,
+	const std::map<dwarf::section_type, Contribution>& contributions) noexcept
+{
+	for (const auto& [type, packageSection] : package.m_sections)
+	{
+		size_t size = 0;
+		const auto data = static_cast<const uint8_t*>(package.load(type, &size));
+		if (data == nullptr)
+			continue;
+		auto section = std::make_unique<Section>();
+		section->fileData = data;
+		section->fileSize = size;
+		if (const auto contributionIt = contributions.find(type);
+			contributionIt != contributions.end())
+		{
+			const auto& contribution = contributionIt->second;
+			if (contribution.offset > size || contribution.size > size - contribution.offset)
+				continue;
+			section->fileData += contribution.offset;
+			section->fileSize = contribution.size;
+		}
+		section->data = section->fileData;
+		section->size = section->fileSize;
+		m_sections[type] = std::move(section);
+	}
+}
+
+void SectionLoader::ReadHeader(Section& section, const std::string& name,
+	bool flagged, bool is64) noexcept
+{
+	section.data = nullptr;
+	section.size = 0;
+	if (flagged == true)
+	{
+		// Elf64_Chdr is a type, padding, a size and an alignment.
+		// Elf32_Chdr is a type, a size and an alignment
+		const size_t headerSize = (is64 == true) ? 24 : 12;
+		if (section.fileSize < headerSize)
+		{
+			section.error = "Section " + name + " is too small for its header";
+			return;
+		}
+		uint32_t type;
+		std::memcpy(&type, section.fileData, sizeof(type));
+		if (type != CompressZlib)
+		{
+			section.error = "Section " + name + " uses an unsupported compression type " +
+				std::to_string(type);
+			return;
+		}
+		if (is64 == true)
+		{
+			uint64_t size;
+			std::memcpy(&size, section.fileData + 8, sizeof(size));
+			section.size = size;
+		}
+		else
+		{
+			uint32_t size;
+			std::memcpy(&size, section.fileData + 4, sizeof(size));
+			section.size = size;
+		}
+		section.streamOffset = headerSize;
+		CheckSize(section, name);
+		return;
+	}
+	// "ZLIB" and the big-endian size
+	if (section.fileSize < 12 || std::memcmp(section.fileData, "ZLIB", 4) != 0)
+	{
+		section.error = "Section " + name + " has no ZLIB header";
+		return;
+	}
+	for (size_t i = 4; i < 12; ++i)
+		section.size = (section.size << 8) | section.fileData[i];
+	section.streamOffset = 12;
+	CheckSize(section, name);
+}
+
+void SectionLoader::CheckSize(Section& section, const std::string& name) noexcept
+{
+	const size_t streamSize = section.fileSize - section.streamOffset.value();
+	if (streamSize <= SIZE_MAX / MaxInflateRatio && section.size > streamSize * MaxInflateRatio)
+	{
+		section.error = "Section " + name + " claims " + std::to_string(section.size) +
+			" bytes, more than its " + std::to_string(streamSize) + " compressed bytes can hold";
+		section.size = 0;
+	}
+}
+
+std::optional<std::string> SectionLoader::Inflate(const Section& section, uint8_t* out) noexcept
+{
+#ifdef DWARFTOCPP_HAS_ZLIB
+	z_stream stream{};
+	if (inflateInit(&stream) != Z_OK)
+		return "Failed to start decompressing";
+	// zlib counts in uInt, so feed sections larger than that in chunks
+	const uint8_t* in = section.fileData + section.streamOffset.value();
+	size_t inLeft = section.fileSize - section.streamOffset.value();
+	size_t outLeft = section.size;
+	int res = Z_OK;
+	while (res == Z_OK)
+	{
+		if (stream.avail_in == 0)
+		{
+			stream.next_in = const_cast<Bytef*>(in);
+			stream.avail_in = static_cast<uInt>(std::min<size_t>(inLeft, UINT_MAX));
+			in += stream.avail_in;
+			inLeft -= stream.avail_in;
+		}
+		if (stream.avail_out == 0)
+		{
+			stream.next_out = out;
+			stream.avail_out = static_cast<uInt>(std::min<size_t>(outLeft, UINT_MAX));
+			out += stream.avail_out;
+			outLeft -= stream.avail_out;
+		}
+		// running out of input or space before the end of the
+		// stream is an error, since both sizes are known
+		res = inflate(&stream, Z_NO_FLUSH);
+	}
+	inflateEnd(&stream);
+	if (res != Z_STREAM_END || stream.avail_out != 0 || outLeft != 0)
+		return "The compressed data is corrupt or has the wrong size";
+	return std::nullopt;
+#else
+	static_cast<void>(section);
+	static_cast<void>(out);
+	return "Compressed sections need zlib, which was not found when building";
+#endif
+}
+
+std::optional<std::string> SectionLoader::Decompress(size_t threadCount) noexcept
+{
+	// place every eager section in one buffer, aligned for whatever
+	// libelfin reads out of it
+	std::vector<std::pair<Section*, size_t>> pending;
+	size_t poolSize = 0;
+	for (const auto type : EagerSections)
+	{
+		const auto sectionIt = m_sections.find(type);
+		if (sectionIt == m_sections.end())
+			continue;
+		auto& section = *sectionIt->second;
+		if (section.error.has_value() == true)
+			return section.error;
+		if (section.streamOffset.has_value() == false)
+			continue;
+		pending.emplace_back(&section, poolSize);
+		poolSize += (section.size + 15) & ~size_t(15);
+	}
+	if (pending.empty() == true)
+		return std::nullopt;
+	m_pool.reset(new (std::nothrow) uint8_t[poolSize]);
+	if (m_pool == nullptr)
+		return "Failed to allocate " + std::to_string(poolSize) + " bytes to decompress into";
+	// each section is one deflate stream, which can only be inflated from
+	// its start, so the sections are decompressed side by side but each
+	// on one thread. toolchains compress without full flush points, so
+	// .debug_info can't be split to parse units as they are inflated
+	TaskPool pool(threadCount);
+	for (const auto& [section, offset] : pending)
+	{
+		// load must not decompress these again
+		std::call_once(section->decompressed, [this, section, offset]()
+			{
+				section->data = m_pool.get() + offset;
+			});
+		pool.Push([section]()
+			{
+				TraceScope scope("load", "Decompress",
+					{ { "bytes", static_cast<uint64_t>(section->size) } });
+				section->error = Inflate(*section, const_cast<uint8_t*>(section->data));
+			});
+	}
+	pool.Run();
+	for (const auto& [section, offset] : pending)
+	{
+		if (section->error.has_value() == true)
+			return section->error;
+	}
+	return std::nullopt;
+}
+
+const void* SectionLoader::load(dwarf::section_type type, size_t* size_out)
+{
+	const auto sectionIt = m_sections.find(type);
+	if (sectionIt == m_sections.end())
+		return nullptr;
+	auto& section = *sectionIt->second;
+	if (section.streamOffset.has_value() == true)
+	{
+		// sections that weren't decompressed up front are decompressed
+		// by the first thread that asks for them
+		std::call_once(section.decompressed, [&section]()
+			{
+				if (section.error.has_value() == true)
+					return;
+				section.buffer.reset(new (std::nothrow) uint8_t[section.size]);
+				if (section.buffer == nullptr)
+				{
+					section.error = "Failed to allocate " + std::to_string(section.size) +
+						" bytes to decompress into";
+					return;
+				}
+				section.error = Inflate(section, section.buffer.get());
+				section.data = section.buffer.get();
+			});
+	}
+	if (section.error.has_value() == true)
+		return nullptr;
+	*size_out = section.size;
+	return section.data;
+}
+
+bool SectionLoader::IsCompressed(const elf::section& section) noexcept
+{
+	return (static_cast<uint64_t>(section.get_hdr().flags) & CompressedFlag) != 0 ||
+		section.get_name().starts_with(".zdebug_") == true;
+}
\ No newline at end of file
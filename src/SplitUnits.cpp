@@ -0,0 +1,328 @@
+#include <DWARFToCPP/SplitUnits.h>
+#include <DWARFToCPP/TaskPool.h>
+#include <DWARFToCPP/Tracer.h>
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#pragma warning(disable : 4996)
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	// DW_AT_dwo_name, and the GNU extensions DWARF 4 split units use
+	constexpr auto AttributeDwoName = static_cast<dwarf::DW_AT>(0x76);
+	constexpr auto AttributeGnuDwoName = static_cast<dwarf::DW_AT>(0x2130);
+	constexpr auto AttributeGnuDwoId = static_cast<dwarf::DW_AT>(0x2131);
+	// DW_UT_skeleton
+	constexpr uint8_t UnitTypeSkeleton = 0x04;
+
+	/// @param version The version of the unit index
+	/// @param column The section identifier of a column of the index
+	/// @return The name of the section the column is for
+	const char* GetColumnSection(uint32_t version, uint32_t column) noexcept
+	{
+		// DWARF 5 reuses the identifiers of sections it replaced
+		constexpr const char* version2Sections[] = { nullptr, ".debug_info", ".debug_types",
+			".debug_abbrev", ".debug_line", ".debug_loc", ".debug_str_offsets",
+			".debug_macinfo", ".debug_macro" };
+		constexpr const char* version5Sections[] = { nullptr, ".debug_info", nullptr,
+			".debug_abbrev", ".debug_line", ".debug_loclists", ".debug_str_offsets",
+			".debug_macro", ".debug_rnglists" };
+		if (column >= std::size(version2Sections))
+			return nullptr;
+		return (version >= 5) ? version5Sections[column] : version2Sections[column];
+	}
+}
+
+std::optional<std::string> SplitUnits::Open(const elf::elf& file, const dwarf::dwarf& data,
+	const std::string& packagePath, size_t threadCount) noexcept
+{
+	std::vector<Skeleton> skeletons;
+	for (const auto& unit : data.compilation_units())
+	{
+		if (auto skeleton = ReadSkeleton(file, unit); skeleton.has_value() == true)
+			skeletons.push_back(std::move(skeleton.value()));
+	}
+	if (skeletons.empty() == true)
+		return std::nullopt;
+	// the package has every unit, so it is used instead of the .dwo files
+	std::vector<std::optional<std::map<dwarf::section_type,
+		SectionLoader::Contribution>>> contributions;
+	if (packagePath.empty() == false)
+	{
+		int fd = open(packagePath.c_str(), O_RDONLY);
+		if (fd < 0)
+			return "Failed to open package " + packagePath;
+		try
+		{
+			m_packageFile.emplace(elf::create_mmap_loader(fd));
+		}
+		catch (const std::exception& e)
+		{
+			return "Failed to load package " + packagePath + ": " + e.what();
+		}
+		m_packageLoader = std::make_shared<SectionLoader>(m_packageFile.value());
+		if (auto error = m_packageLoader->Decompress(threadCount); error.has_value() == true)
+			return "Failed to decompress package " + packagePath + ": " + error.value();
+		if (auto error = ReadPackageIndex(skeletons, contributions); error.has_value() == true)
+			return "Failed to read package " + packagePath + ": " + error.value();
+	}
+	// opening and mapping many files is mostly waiting, so do it on
+	// every thread. each task only writes its own slot
+	std::vector<std::unique_ptr<SplitFile>> splitFiles(skeletons.size());
+	TaskPool pool(threadCount);
+	for (size_t skeletonIndex = 0; skeletonIndex < skeletons.size(); ++skeletonIndex)
+	{
+		pool.Push([this, &skeletons, &contributions, &splitFiles, skeletonIndex]()
+			{
+				const auto& skeleton = skeletons[skeletonIndex];
+				auto& splitFile = splitFiles[skeletonIndex];
+				if (m_packageLoader == nullptr)
+				{
+					splitFile = OpenDwo(skeleton);
+					return;
+				}
+				if (contributions[skeletonIndex].has_value() == false)
+					return;
+				try
+				{
+					splitFile = std::make_unique<SplitFile>();
+					splitFile->loader = std::make_shared<SectionLoader>(*m_packageLoader,
+						contributions[skeletonIndex].value());
+					splitFile->data = dwarf::dwarf(splitFile->loader);
+					if (Preload(*splitFile) == false)
+						splitFile.reset();
+				}
+				catch (const std::exception&)
+				{
+					splitFile.reset();
+				}
+			});
+	}
+	{
+		TraceScope openScope("load", "Open split units",
+			{ { "units", static_cast<uint64_t>(skeletons.size()) } });
+		pool.Run();
+	}
+	for (size_t skeletonIndex = 0; skeletonIndex < skeletons.size(); ++skeletonIndex)
+	{
+		auto& splitFile = splitFiles[skeletonIndex];
+		if (splitFile == nullptr)
+		{
+			++m_missingCount;
+			continue;
+		}
+		size_t bytes = 0;
+		splitFile->loader->load(dwarf::section_type::info, &bytes);
+		m_units.emplace(skeletons[skeletonIndex].unit,
+			Unit{ &splitFile->data.compilation_units().front(), bytes });
+		m_files.push_back(std::move(splitFile));
+	}
+	return std::nullopt;
+}
+
+const SplitUnits::Unit* SplitUnits::Find(const dwarf::compilation_unit& skeleton) const noexcept
+{
+	const auto unitIt = m_units.find(&skeleton);
+	if (unitIt == m_units.end())
+		return nullptr;
+	return &unitIt->second;
+}
+
+bool SplitUnits::Preload(SplitFile& splitFile) noexcept
+{
+	try
+	{
+		splitFile.data.get_section(dwarf::section_type::str);
+	}
+	catch (const std::exception&)
+	{
+		// not every file has a string section
+	}
+	try
+	{
+		const auto& units = splitFile.data.compilation_units();
+		if (units.empty() == true)
+			return false;
+		units.front().root();
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	return true;
+}
+
+std::optional<SplitUnits::Skeleton> SplitUnits::ReadSkeleton(const elf::elf& file,
+	const dwarf::compilation_unit& unit) noexcept
+{
+	Skeleton skeleton{ &unit, std::string(), std::nullopt };
+	try
+	{
+		const auto& root = unit.root();
+		const auto nameAttribute = (root.has(AttributeDwoName) == true) ?
+			AttributeDwoName : AttributeGnuDwoName;
+		if (root.has(nameAttribute) == false)
+			return std::nullopt;
+		std::filesystem::path dwoPath = root[nameAttribute].as_string();
+		// relative names are relative to where the unit was compiled
+		if (dwoPath.is_relative() == true && root.has(dwarf::DW_AT::comp_dir) == true)
+			dwoPath = std::filesystem::path(root[dwarf::DW_AT::comp_dir].as_string()) / dwoPath;
+		skeleton.dwoPath = dwoPath.string();
+		if (root.has(AttributeGnuDwoId) == true)
+			skeleton.dwoId = root[AttributeGnuDwoId].as_uconstant();
+	}
+	catch (const std::exception&)
+	{
+		// libelfin can't read every form a skeleton may use
+		return std::nullopt;
+	}
+	if (skeleton.dwoId.has_value() == true)
+		return skeleton;
+	// DWARF 5 moves the ID into the unit header, after the length, the
+	// version, the unit type, the address size and the abbreviation offset
+	const auto& info = file.get_section(".debug_info");
+	if (info.valid() == false || SectionLoader::IsCompressed(info) == true)
+		return skeleton;
+	const auto infoData = static_cast<const uint8_t*>(info.data());
+	const auto offset = unit.get_section_offset();
+	if (offset + 4 > info.size())
+		return skeleton;
+	uint32_t length;
+	std::memcpy(&length, infoData + offset, sizeof(length));
+	const size_t offsetSize = (length == 0xffffffff) ? 8 : 4;
+	const size_t headerOffset = offset + ((offsetSize == 8) ? 12 : 4);
+	const size_t idOffset = headerOffset + 4 + offsetSize;
+	if (idOffset + 8 > info.size())
+		return skeleton;
+	uint16_t version;
+	std::memcpy(&version, infoData + headerOffset, sizeof(version));
+	if (version < 5 || infoData[headerOffset + 2] != UnitTypeSkeleton)
+		return skeleton;
+	uint64_t dwoId;
+	std::memcpy(&dwoId, infoData + idOffset, sizeof(dwoId));
+	skeleton.dwoId = dwoId;
+	return skeleton;
+}
+
+std::unique_ptr<SplitUnits::SplitFile> SplitUnits::OpenDwo(const Skeleton& skeleton) noexcept
+{
+	int fd = open(skeleton.dwoPath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+	try
+	{
+		auto splitFile = std::make_unique<SplitFile>();
+		splitFile->file = elf::elf(elf::create_mmap_loader(fd));
+		splitFile->loader = std::make_shared<SectionLoader>(splitFile->file);
+		if (splitFile->loader->Decompress(1).has_value() == true)
+			return nullptr;
+		splitFile->data = dwarf::dwarf(splitFile->loader);
+		if (Preload(*splitFile) == false)
+			return nullptr;
+		// a .dwo file from another build would have other types
+		const auto& root = splitFile->data.compilation_units().front().root();
+		if (skeleton.dwoId.has_value() == true && root.has(AttributeGnuDwoId) == true &&
+			root[AttributeGnuDwoId].as_uconstant() != skeleton.dwoId.value())
+			return nullptr;
+		return splitFile;
+	}
+	catch (const std::exception&)
+	{
+		return nullptr;
+	}
+}
+
+std::optional<std::string> SplitUnits::ReadPackageIndex(const std::vector<Skeleton>& skeletons,
+	std::vector<std::optional<std::map<dwarf::section_type,
+	SectionLoader::Contribution>>>& contributions) const noexcept
+{
+	contributions.resize(skeletons.size());
+	const auto& index = m_packageFile->get_section(".debug_cu_index");
+	if (index.valid() == false)
+		return "The package has no unit index";
+	if (SectionLoader::IsCompressed(index) == true)
+		return "The package's unit index is compressed";
+	const auto indexData = static_cast<const uint8_t*>(index.data());
+	const auto read32 = [indexData](size_t offset)
+	{
+		uint32_t value;
+		std::memcpy(&value, indexData + offset, sizeof(value));
+		return value;
+	};
+	// the header is the version, then the number of columns, units and
+	// hash slots. DWARF 5 shrinks the version to 16 bits
+	if (index.size() < 16)
+		return "The unit index is truncated";
+	const uint32_t version = read32(0) & 0xffff;
+	const uint32_t columnCount = read32(4);
+	const uint32_t unitCount = read32(8);
+	const uint32_t slotCount = read32(12);
+	if (version != 2 && version != 5)
+		return "The unit index has unsupported version " + std::to_string(version);
+	if ((slotCount & (slotCount - 1)) != 0)
+		return "The unit index has a slot count that isn't a power of 2";
+	// the hash table of IDs, the row of each slot, the column headers,
+	// then the offsets and the sizes of each row
+	const size_t idsOffset = 16;
+	const size_t rowsOffset = idsOffset + size_t(slotCount) * 8;
+	const size_t columnsOffset = rowsOffset + size_t(slotCount) * 4;
+	const size_t offsetsOffset = columnsOffset + size_t(columnCount) * 4;
+	const size_t sizesOffset = offsetsOffset + size_t(unitCount) * columnCount * 4;
+	if (sizesOffset + size_t(unitCount) * columnCount * 4 > index.size())
+		return "The unit index is truncated";
+	std::vector<std::optional<dwarf::section_type>> columnTypes(columnCount);
+	for (uint32_t column = 0; column < columnCount; ++column)
+	{
+		const auto name = GetColumnSection(version, read32(columnsOffset + column * 4));
+		dwarf::section_type type;
+		if (name != nullptr && dwarf::elf::elf_type_to_section_type(name, &type) == true)
+			columnTypes[column] = type;
+	}
+	const uint64_t mask = slotCount - 1;
+	for (size_t skeletonIndex = 0; skeletonIndex < skeletons.size(); ++skeletonIndex)
+	{
+		const auto& dwoId = skeletons[skeletonIndex].dwoId;
+		if (dwoId.has_value() == false || slotCount == 0)
+			continue;
+		// open addressing, with a step taken from the upper half of the ID
+		const uint64_t id = dwoId.value();
+		const uint64_t step = ((id >> 32) & mask) | 1;
+		uint32_t row = 0;
+		for (uint64_t slot = id & mask, probe = 0; probe < slotCount;
+			slot = (slot + step) & mask, ++probe)
+		{
+			uint64_t slotId;
+			std::memcpy(&slotId, indexData + idsOffset + slot * 8, sizeof(slotId));
+			const uint32_t slotRow = read32(rowsOffset + slot * 4);
+			if (slotId == id)
+			{
+				row = slotRow;
+				break;
+			}
+			if (slotId == 0 && slotRow == 0)
+				break;
+		}
+		// rows start at 1, since 0 marks an empty slot
+		if (row == 0 || row > unitCount)
+			continue;
+		auto& unitContributions = contributions[skeletonIndex].emplace();
+		for (uint32_t column = 0; column < columnCount; ++column)
+		{
+			if (columnTypes[column].has_value() == false)
+				continue;
+			const size_t cell = (size_t(row) - 1) * columnCount + column;
+			unitContributions[columnTypes[column].value()] = SectionLoader::Contribution{
+				read32(offsetsOffset + cell * 4), read32(sizesOffset + cell * 4) };
+		}
+	}
+	return std::nullopt;
+}
\ No newline at end of file
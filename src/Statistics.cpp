@@ -0,0 +1,60 @@
+#include <DWARFToCPP/Statistics.h>
+
+using namespace DWARFToCPP;
+
+void ParseStatistics::Merge(const ParseStatistics& other) noexcept
+{
+	other.tags.ForEach([this](dwarf::DW_TAG tag, const TagCounts& counts)
+		{
+			auto& mergedCounts = tags[tag];
+			mergedCounts.visited += counts.visited;
+			mergedCounts.created += counts.created;
+		});
+	memoHits += other.memoHits;
+	memoMisses += other.memoMisses;
+	odrShared += other.odrShared;
+	typeUnitShared += other.typeUnitShared;
+}
+
+void ParseStatistics::PrintJSON(std::ostream& outFile) const noexcept
+{
+	size_t bytesDecoded = 0;
+	double parseSeconds = 0;
+	outFile << "{\n\t\"units\": [";
+	for (size_t unitIndex = 0; unitIndex < units.size(); ++unitIndex)
+	{
+		const auto& unit = units[unitIndex];
+		// cached units are not decoded
+		if (unit.cached == false)
+			bytesDecoded += unit.bytes;
+		parseSeconds += unit.seconds;
+		outFile << ((unitIndex == 0) ? "\n" : ",\n") <<
+			"\t\t{ \"offset\": " << unit.offset <<
+			", \"bytes\": " << unit.bytes <<
+			", \"seconds\": " << unit.seconds <<
+			", \"entries\": " << unit.entries <<
+			", \"cached\": " << ((unit.cached == true) ? "true" : "false") << " }";
+	}
+	outFile << "\n\t],\n"
+		"\t\"bytesDecoded\": " << bytesDecoded << ",\n"
+		"\t\"parseSeconds\": " << parseSeconds << ",\n"
+		"\t\"tags\": {";
+	bool first = true;
+	tags.ForEach([&outFile, &first](dwarf::DW_TAG tag, const TagCounts& counts)
+		{
+			outFile << ((first == true) ? "\n" : ",\n") <<
+				"\t\t\"" << to_string(tag) << "\": { \"visited\": " << counts.visited <<
+				", \"created\": " << counts.created << " }";
+			first = false;
+		});
+	outFile << "\n\t},\n"
+		"\t\"memo\": { \"hits\": " << memoHits << ", \"misses\": " << memoMisses <<
+		", \"shared\": " << odrShared << ", \"typeUnits\": " << typeUnitShared << " },\n"
+		"\t\"merge\": { \"conceptsAdded\": " << conceptsAdded <<
+		", \"namespacesMerged\": " << namespacesMerged <<
+		", \"duplicatesSkipped\": " << duplicatesSkipped <<
+		", \"seconds\": " << mergeSeconds << " },\n"
+		"\t\"peakNodeBytes\": " << peakNodeBytes << ",\n"
+		"\t\"peakResidentBytes\": " << peakResidentBytes << "\n"
+		"}\n";
+}
\ No newline at end of file
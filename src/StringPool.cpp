@@ -0,0 +1,38 @@
+#include <DWARFToCPP/StringPool.h>
+
+#include <cstring>
+
+using namespace DWARFToCPP;
+
+InternedString StringPool::Intern(std::string_view str) noexcept
+{
+	// every empty string is the default handle
+	if (str.empty() == true)
+		return InternedString();
+	const Key key{ str, std::hash<std::string_view>()(str) };
+	auto& shard = ShardFor(key.hash);
+	std::scoped_lock lock(shard.mutex);
+	if (const auto entryIt = shard.entries.find(key);
+		entryIt != shard.entries.end())
+		return InternedString(entryIt->second);
+	// copy the string into the pool so the entry owns it
+	auto characters = static_cast<char*>(shard.arena.Allocate(str.size(), 1));
+	std::memcpy(characters, str.data(), str.size());
+	const auto entry = shard.arena.Create<InternedString::Entry>(
+		InternedString::Entry{ std::string_view(characters, str.size()), key.hash });
+	shard.entries.emplace(Key{ entry->view, key.hash }, entry);
+	return InternedString(entry);
+}
+
+std::optional<InternedString> StringPool::Find(std::string_view str) const noexcept
+{
+	if (str.empty() == true)
+		return InternedString();
+	const Key key{ str, std::hash<std::string_view>()(str) };
+	const auto& shard = ShardFor(key.hash);
+	std::scoped_lock lock(shard.mutex);
+	const auto entryIt = shard.entries.find(key);
+	if (entryIt == shard.entries.end())
+		return std::nullopt;
+	return InternedString(entryIt->second);
+}
@@ -0,0 +1,133 @@
+#include <DWARFToCPP/TaskPool.h>
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+using namespace DWARFToCPP;
+
+namespace
+{
+	// the pool and worker running on the current thread, if any
+	thread_local const TaskPool* t_currentPool = nullptr;
+	thread_local size_t t_workerIndex = 0;
+}
+
+TaskPool::TaskPool(size_t threadCount) noexcept :
+	m_workerCount(std::max<size_t>((threadCount == 0) ?
+		std::thread::hardware_concurrency() : threadCount, 1)),
+	m_workers(std::make_unique<Worker[]>(m_workerCount)) {}
+
+void TaskPool::Push(Task task) noexcept
+{
+	++m_pendingTasks;
+	// keep nested tasks local so related work stays on one thread
+	// until another thread runs dry and steals it
+	if (t_currentPool == this)
+	{
+		auto& worker = m_workers[t_workerIndex];
+		{
+			std::scoped_lock lock(worker.mutex);
+			worker.tasks.push_back(std::move(task));
+		}
+		Wake(false);
+		return;
+	}
+	auto& worker = m_workers[m_nextWorker++ % m_workerCount];
+	{
+		std::scoped_lock lock(worker.mutex);
+		worker.tasks.push_front(std::move(task));
+	}
+	Wake(false);
+}
+
+void TaskPool::Run() noexcept
+{
+	std::vector<std::thread> threads;
+	try
+	{
+		for (size_t i = 1; i < m_workerCount; ++i)
+			threads.emplace_back(&TaskPool::RunWorker, this, i);
+	}
+	catch (const std::system_error&)
+	{
+		// the threads that did start steal the rest of the work
+	}
+	RunWorker(0);
+	for (auto& thread : threads)
+		thread.join();
+}
+
+void TaskPool::Wake(bool all) noexcept
+{
+	{
+		std::scoped_lock lock(m_idleMutex);
+		++m_wakeups;
+	}
+	if (all == true)
+		m_idleCondition.notify_all();
+	else
+		m_idleCondition.notify_one();
+}
+
+std::optional<TaskPool::Task> TaskPool::Pop(size_t workerIndex) noexcept
+{
+	auto& worker = m_workers[workerIndex];
+	std::scoped_lock lock(worker.mutex);
+	if (worker.tasks.empty() == true)
+		return std::nullopt;
+	auto task = std::move(worker.tasks.back());
+	worker.tasks.pop_back();
+	return task;
+}
+
+std::optional<TaskPool::Task> TaskPool::Steal(size_t thiefIndex) noexcept
+{
+	for (size_t i = 1; i < m_workerCount; ++i)
+	{
+		auto& victim = m_workers[(thiefIndex + i) % m_workerCount];
+		std::scoped_lock lock(victim.mutex);
+		if (victim.tasks.empty() == true)
+			continue;
+		auto task = std::move(victim.tasks.front());
+		victim.tasks.pop_front();
+		return task;
+	}
+	return std::nullopt;
+}
+
+void TaskPool::RunWorker(size_t workerIndex) noexcept
+{
+	const auto previousPool = t_currentPool;
+	const auto previousIndex = t_workerIndex;
+	t_currentPool = this;
+	t_workerIndex = workerIndex;
+	while (m_pendingTasks > 0)
+	{
+		// read before looking for work, so a task queued after the
+		// queues were found empty still wakes this thread
+		uint64_t wakeups;
+		{
+			std::scoped_lock lock(m_idleMutex);
+			wakeups = m_wakeups;
+		}
+		auto task = Pop(workerIndex);
+		if (task.has_value() == false)
+			task = Steal(workerIndex);
+		if (task.has_value() == false)
+		{
+			// another thread is still running a task that may queue more
+			std::unique_lock lock(m_idleMutex);
+			m_idleCondition.wait(lock, [this, wakeups]()
+				{
+					return m_wakeups != wakeups || m_pendingTasks == 0;
+				});
+			continue;
+		}
+		(*task)();
+		if (--m_pendingTasks == 0)
+			Wake(true);
+	}
+	t_currentPool = previousPool;
+	t_workerIndex = previousIndex;
+}
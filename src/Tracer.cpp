@@ -0,0 +1,82 @@
+#include <DWARFToCPP/Tracer.h>
+
+#include <fstream>
+#include <iomanip>
+
+using namespace DWARFToCPP;
+
+std::atomic<Tracer*> Tracer::s_current = nullptr;
+
+namespace
+{
+	// small numbers read better than thread ids in a timeline
+	std::atomic_size_t g_threadCount = 0;
+	thread_local const size_t t_threadIndex = ++g_threadCount;
+
+	void WriteEscaped(std::ostream& outFile, std::string_view str) noexcept
+	{
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\')
+				outFile << '\\' << c;
+			else if (static_cast<unsigned char>(c) < 0x20)
+				outFile << ' ';
+			else
+				outFile << c;
+		}
+	}
+}
+
+Tracer::Tracer(std::chrono::microseconds threshold) noexcept :
+	m_start(Clock::now()), m_threshold(threshold)
+{
+	s_current = this;
+}
+
+Tracer::~Tracer()
+{
+	s_current = nullptr;
+}
+
+void Tracer::Record(const char* category, std::string name, std::vector<TraceArg> args,
+	Clock::time_point start, Clock::time_point end, bool thresholded) noexcept
+{
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+	if (thresholded == true && duration < m_threshold)
+		return;
+	const auto relativeStart = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_start);
+	std::scoped_lock lock(m_mutex);
+	m_events.push_back(Event{ category, std::move(name), std::move(args),
+		relativeStart, duration, t_threadIndex });
+}
+
+std::optional<std::string> Tracer::Write(const std::string& path) const noexcept
+{
+	std::ofstream outFile(path, std::ios::trunc);
+	if (outFile.good() == false)
+		return "Failed to open trace file " + path;
+	// complete events, with times in microseconds
+	outFile << std::fixed << std::setprecision(3) <<
+		"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	std::scoped_lock lock(m_mutex);
+	bool first = true;
+	for (const auto& event : m_events)
+	{
+		outFile << ((first == true) ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" <<
+			event.thread << ",\"cat\":\"" << event.category << "\",\"name\":\"";
+		WriteEscaped(outFile, event.name);
+		outFile << "\",\"ts\":" << static_cast<double>(event.start.count()) / 1e3 <<
+			",\"dur\":" << static_cast<double>(event.duration.count()) / 1e3 << ",\"args\":{";
+		for (size_t argIndex = 0; argIndex < event.args.size(); ++argIndex)
+		{
+			outFile << ((argIndex == 0) ? "\"" : ",\"") << event.args[argIndex].name <<
+				"\":" << event.args[argIndex].value;
+		}
+		outFile << "}}";
+		first = false;
+	}
+	outFile << "\n]}\n";
+	if (outFile.good() == false)
+		return "Failed to write trace file " + path;
+	return std::nullopt;
+}
\ No newline at end of file